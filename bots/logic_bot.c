@@ -0,0 +1,131 @@
+/* example bot plugin: opens or flags around numbers that decide their neighbors on their own and
+ * guesses a random closed tile when none do
+ * build with make plugins, run with minesweeper --bot-plugin=bin/linux/debug/bots/logic_bot.so */
+
+#include <stdlib.h>
+
+#include "../src/bot_plugin_api.h"
+
+typedef struct logic_bot
+{
+	uint64_t rng;
+} logic_bot;
+
+static uint64_t next_random(logic_bot* bot)
+{
+	uint64_t z = (bot->rng += 0x9e3779b97f4a7c15ull);
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+	return z ^ (z >> 31);
+}
+
+static void* logic_create(const ms_board_view* view)
+{
+	(void)view;
+	return calloc(1, sizeof(logic_bot));
+}
+
+static void logic_destroy(void* bot)
+{
+	free(bot);
+}
+
+static void logic_new_game(void* bot, const ms_board_view* view)
+{
+	(void)bot;
+	(void)view;
+}
+
+/* moves for the closed neighbors of one number, all opens or all flags, so no tile gets two */
+static uint32_t decide_around(const ms_board_view* view, uint32_t row, uint32_t col, ms_move* moves, uint32_t capacity)
+{
+	const uint8_t* tiles = view->tiles;
+	const uint32_t number = tiles[row * view->width + col];
+
+	uint32_t closed = 0, flagged = 0;
+	uint32_t neighbors[8];
+	for(int i = -1; i <= 1; i++) {
+		for(int j = -1; j <= 1; j++) {
+			const int64_t r = (int64_t)row + i, c = (int64_t)col + j;
+			if((i == 0 && j == 0) || r < 0 || c < 0 || r >= view->height || c >= view->width)
+				continue;
+
+			const uint32_t index = (uint32_t)r * view->width + (uint32_t)c;
+			if(tiles[index] == MS_TILE_FLAGGED)
+				flagged++;
+			else if(tiles[index] == MS_TILE_CLOSED)
+				neighbors[closed++] = index;
+		}
+	}
+
+	if(closed == 0 || closed > capacity)
+		return 0;
+
+	uint32_t kind;
+	if(flagged == number)
+		kind = MS_MOVE_OPEN;
+	else if(flagged + closed == number)
+		kind = MS_MOVE_FLAG;
+	else
+		return 0;
+
+	for(uint32_t i = 0; i < closed; i++) {
+		moves[i].tile = neighbors[i];
+		moves[i].kind = kind;
+	}
+	return closed;
+}
+
+static uint32_t logic_next_moves(void* state, const ms_board_view* view, ms_move* moves, uint32_t capacity)
+{
+	logic_bot* bot = state;
+	const uint32_t tiles = view->width * view->height;
+	if(capacity == 0)
+		return 0;
+
+	for(uint32_t row = 0; row < view->height; row++) {
+		for(uint32_t col = 0; col < view->width; col++) {
+			const uint8_t tile = view->tiles[row * view->width + col];
+			if(tile == 0 || tile > 8)
+				continue;
+
+			const uint32_t count = decide_around(view, row, col, moves, capacity);
+			if(count != 0)
+				return count;
+		}
+	}
+
+	/* nothing is certain, rejection sampling finds a closed tile quickly unless almost none are left */
+	for(int attempt = 0; attempt < 64; attempt++) {
+		const uint32_t index = (uint32_t)((next_random(bot) >> 32) * tiles >> 32);
+		if(view->tiles[index] == MS_TILE_CLOSED) {
+			moves[0].tile = index;
+			moves[0].kind = MS_MOVE_OPEN;
+			return 1;
+		}
+	}
+
+	for(uint32_t index = 0; index < tiles; index++) {
+		if(view->tiles[index] == MS_TILE_CLOSED) {
+			moves[0].tile = index;
+			moves[0].kind = MS_MOVE_OPEN;
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+static const ms_bot_plugin LOGIC_BOT = {
+	.api_version = MS_BOT_API_VERSION,
+	.name = "logic bot",
+	.create = logic_create,
+	.destroy = logic_destroy,
+	.new_game = logic_new_game,
+	.next_moves = logic_next_moves,
+};
+
+const ms_bot_plugin* minesweeper_bot_plugin(void)
+{
+	return &LOGIC_BOT;
+}
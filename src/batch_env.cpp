@@ -0,0 +1,155 @@
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "batch_env.hpp"
+#include "mine_oracle.hpp"
+
+// flood fill frontier as (cell, observation) index pairs, one per thread stepping boards
+static thread_local std::vector<std::pair<uint32_t, uint32_t>> g_frontier;
+
+static uint64_t next_random(uint64_t* state)
+{
+	*state += 0x9e3779b97f4a7c15ull;
+	return oracle_mix(*state);
+}
+
+void batch_env_init(batch_env* env, int count, int width, int height, int bombcount, uint64_t seed)
+{
+	env->count = count;
+	env->width = width;
+	env->height = height;
+	env->tiles = (size_t)width * height;
+	env->padded_tiles = (size_t)(width + 2) * (height + 2);
+	env->bombcount = std::min<int>(bombcount, (int)env->tiles);
+
+	env->cells.assign(env->padded_tiles * count, BATCH_CELL_BORDER);
+	env->observations.assign(env->tiles * count, TILE_VIEW_CLOSED);
+	env->rewards.assign(count, 0.0f);
+	env->dones.assign(count, 0);
+	env->opened.assign(count, 0);
+	env->rng.resize(count);
+
+	for(int board = 0; board < count; board++) {
+		env->rng[board] = oracle_mix(seed) ^ oracle_mix((uint64_t)board + 1);
+		batch_env_reset(env, board);
+	}
+}
+
+void batch_env_reset(batch_env* env, int board)
+{
+	const int padded_width = env->width + 2;
+	uint8_t* cells = &env->cells[env->padded_tiles * board];
+
+	for(int row = 1; row <= env->height; row++)
+		std::memset(cells + row * padded_width + 1, TILE_EMPTY, env->width);
+	std::memset(&env->observations[env->tiles * board], TILE_VIEW_CLOSED, env->tiles);
+	env->opened[board] = 0;
+
+	// each mine bumps its neighbors, cheaper than counting around every tile on sparse boards
+	const int offsets[8] = { -padded_width - 1, -padded_width, -padded_width + 1, -1, 1, padded_width - 1, padded_width, padded_width + 1 };
+	for(int placed = 0; placed < env->bombcount;) {
+		const uint64_t tile = ((next_random(&env->rng[board]) >> 32) * env->tiles) >> 32;
+		uint8_t& cell = cells[(tile / env->width + 1) * padded_width + tile % env->width + 1];
+		if(cell == TILE_BOMB)
+			continue;
+
+		cell = TILE_BOMB;
+		placed++;
+
+		for(int offset : offsets) {
+			uint8_t& neighbor = (&cell)[offset];
+			if(neighbor < TILE_BOMB)
+				neighbor++;
+		}
+	}
+}
+
+// opens a closed safe tile and the empty area around it, returns how many tiles were opened
+static uint32_t flood_open(const batch_env* env, uint8_t* cells, uint8_t* observations, uint32_t cell, uint32_t observation)
+{
+	const int padded_width = env->width + 2;
+	const struct { int cell, observation; } offsets[8] = {
+		{ -padded_width - 1, -env->width - 1 }, { -padded_width, -env->width }, { -padded_width + 1, -env->width + 1 },
+		{ -1, -1 }, { 1, 1 },
+		{ padded_width - 1, env->width - 1 }, { padded_width, env->width }, { padded_width + 1, env->width + 1 },
+	};
+
+	std::vector<std::pair<uint32_t, uint32_t>>& frontier = g_frontier;
+	uint32_t opened = 1;
+	observations[observation] = cells[cell];
+	if(cells[cell] == TILE_EMPTY)
+		frontier.push_back({cell, observation});
+
+	while(!frontier.empty()) {
+		const auto [from_cell, from_observation] = frontier.back();
+		frontier.pop_back();
+
+		for(const auto& offset : offsets) {
+			const uint32_t to_cell = from_cell + offset.cell;
+			const uint32_t to_observation = from_observation + offset.observation;
+
+			// the border stops the fill before the observation index could wrap to the next row
+			if(cells[to_cell] == BATCH_CELL_BORDER || observations[to_observation] != TILE_VIEW_CLOSED)
+				continue;
+
+			observations[to_observation] = cells[to_cell];
+			opened++;
+			if(cells[to_cell] == TILE_EMPTY)
+				frontier.push_back({to_cell, to_observation});
+		}
+	}
+
+	return opened;
+}
+
+void batch_env_step_range(batch_env* env, const int32_t* actions, int first, int last)
+{
+	const uint32_t safe_tiles = (uint32_t)(env->tiles - env->bombcount);
+	const float reward_per_tile = safe_tiles > 0 ? REWARD_CLEARED / safe_tiles : 0.0f;
+
+	for(int board = first; board < last; board++) {
+		uint8_t* cells = &env->cells[env->padded_tiles * board];
+		uint8_t* observations = &env->observations[env->tiles * board];
+		const int64_t action = actions[board];
+
+		float reward = REWARD_WASTED;
+		bool done = false;
+
+		if(action >= (int64_t)env->tiles && action < 2 * (int64_t)env->tiles) {
+			uint8_t& view = observations[action - env->tiles];
+			if(view == TILE_VIEW_CLOSED || view == TILE_VIEW_FLAGGED) {
+				view = view == TILE_VIEW_CLOSED ? TILE_VIEW_FLAGGED : TILE_VIEW_CLOSED;
+				reward = 0.0f;
+			}
+		}
+		else if(action >= 0 && action < (int64_t)env->tiles && observations[action] == TILE_VIEW_CLOSED) {
+			const uint32_t cell = (uint32_t)((action / env->width + 1) * (env->width + 2) + action % env->width + 1);
+
+			if(cells[cell] == TILE_BOMB) {
+				reward = REWARD_MINE;
+				done = true;
+			}
+			else {
+				const uint32_t opened = flood_open(env, cells, observations, cell, (uint32_t)action);
+				env->opened[board] += opened;
+				reward = opened * reward_per_tile;
+
+				if(env->opened[board] == safe_tiles) {
+					reward += REWARD_WIN;
+					done = true;
+				}
+			}
+		}
+
+		env->rewards[board] = reward;
+		env->dones[board] = done;
+		if(done)
+			batch_env_reset(env, board);
+	}
+}
+
+void batch_env_step(batch_env* env, const int32_t* actions)
+{
+	batch_env_step_range(env, actions, 0, env->count);
+}
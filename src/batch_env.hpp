@@ -0,0 +1,48 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "minesweeper.hpp"
+
+// rewards per step, opening every safe tile adds up to REWARD_CLEARED on top of REWARD_WIN
+constexpr float REWARD_CLEARED = 1.0f;
+constexpr float REWARD_WIN = 1.0f;
+constexpr float REWARD_MINE = -1.0f;
+// opening an open or flagged tile, or an action off the board
+constexpr float REWARD_WASTED = -0.01f;
+
+constexpr uint8_t BATCH_CELL_BORDER = 0xff;
+
+// many boards of one size stepped together for bot training, in structure-of-arrays form
+// every array is indexed by board, the per tile ones hold board after board
+// an action is a tile index row * width + col (0-based), adding width * height flags the tile instead
+struct batch_env
+{
+	int count = 0;
+	int width = 0, height = 0;
+	int bombcount = 0;
+	size_t tiles = 0;        // per board
+	size_t padded_tiles = 0; // per board in cells, with a border so flood fills skip bounds checks
+
+	// TileData with a border of BATCH_CELL_BORDER around each board, never handed out
+	std::vector<uint8_t> cells;
+
+	// what step returns, owned here and reused every step
+	std::vector<uint8_t> observations; // TileView, count * tiles
+	std::vector<float> rewards;
+	std::vector<uint8_t> dones; // the board was lost or won this step, its observation is already the next board's
+
+	std::vector<uint32_t> opened; // safe tiles opened so far
+	std::vector<uint64_t> rng;    // splitmix64 state per board
+};
+
+// all boards start fresh, board i draws its mines from seed and i
+void batch_env_init(batch_env* env, int count, int width, int height, int bombcount, uint64_t seed);
+void batch_env_reset(batch_env* env, int board);
+
+// actions has one entry per board, no allocations once the first step has grown the flood fill stack
+void batch_env_step(batch_env* env, const int32_t* actions);
+
+// steps boards [first, last) only, slices that don't overlap can be stepped from different threads
+void batch_env_step_range(batch_env* env, const int32_t* actions, int first, int last);
@@ -0,0 +1,197 @@
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+
+#include "board_renderer.hpp"
+
+// below this on-screen tile pitch the board is drawn from the lod texture instead of sprites
+constexpr float LOD_TILE_PIXELS = 6.0f;
+
+// longest side of the minimap in screen pixels
+constexpr int MINIMAP_SIZE = 200;
+constexpr int MINIMAP_MARGIN = 10;
+
+void render_context_init(render_context* context, RenderBackend* backend, TTF_Font* font)
+{
+	context->backend = backend;
+
+	context->bomb = load_and_render_image_to_texture(backend, "assets/bomb.png");
+	context->flag = load_and_render_image_to_texture(backend, "assets/flag.png");
+
+	glyph_cache_init(&context->glyphs, font);
+}
+
+void render_context_destroy(render_context* context)
+{
+	if(context->board) {
+		lod_destroy(context->backend, &context->lod);
+		minimap_destroy(context->backend, &context->map);
+	}
+
+	glyph_cache_destroy(context->backend, &context->glyphs);
+	context->backend->destroy_texture(context->bomb);
+	context->backend->destroy_texture(context->flag);
+}
+
+void render_set_board(render_context* context, Minesweeper* board)
+{
+	if(context->board) {
+		lod_destroy(context->backend, &context->lod);
+		minimap_destroy(context->backend, &context->map);
+	}
+
+	context->board = board;
+	lod_create(context->backend, &context->lod, board);
+	minimap_create(context->backend, &context->map, board, MINIMAP_SIZE);
+}
+
+static void render_lod(render_context* context)
+{
+	const camera& cam = context->cam;
+	const lod_map& lod = context->lod;
+
+	const float board_world_x = OUTSIDE_PADDING, board_world_y = OUTSIDE_PADDING;
+	const float scale = camera_scale(cam);
+	const int board_x = world_to_screen(board_world_x, cam.x, scale);
+	const int board_y = world_to_screen(board_world_y, cam.y, scale);
+
+	const SDL_Rect board_rect = {
+		.x = board_x,
+		.y = board_y,
+		.w = world_to_screen(board_world_x + lod.tex_w * lod.block * TILE_PITCH_X, cam.x, scale) - board_x,
+		.h = world_to_screen(board_world_y + lod.tex_h * lod.block * TILE_PITCH_Y, cam.y, scale) - board_y
+	};
+
+	lod_render(context->backend, &context->lod, context->board, &board_rect);
+}
+
+static void render_sprites(render_context* context)
+{
+	const Minesweeper* game = context->board;
+	const camera& cam = context->cam;
+
+	// numbers are rasterized for the current tile size once and then reused
+	const int tile_pixels = (int)std::lround(TILE_HEIGHT * camera_scale(cam));
+	RenderBackend* backend = context->backend;
+	const glyph_set* glyphs = glyph_cache_get(backend, &context->glyphs, tile_pixels);
+
+	// only the tiles inside the viewport are drawn, frame cost doesn't depend on board size
+	layout_update(&context->layout, cam, game, glyphs);
+	const tile_layout& layout = context->layout;
+	const tile_range& visible = layout.visible;
+
+	for(int row = visible.first_row; row <= visible.last_row; row++) 
+	{
+		const int layout_row = row - visible.first_row;
+
+		for(int col = visible.first_col; col <= visible.last_col; col++) 
+		{
+			const int layout_col = col - visible.first_col;
+
+			const Tile& tile = game->tilemap[row][col];
+
+			int tile_number = tile.data - 1;
+			
+			const SDL_Rect bound_rect = layout_rect(layout.bound_cols, layout.bound_rows, layout_col, layout_row);
+			
+			if(tile.open) {
+				if(tile.data != TILE_BOMB && tile.data != TILE_EMPTY) {
+					const SDL_Rect number_rect = layout_rect(layout.number_cols[tile_number], layout.number_rows[tile_number], layout_col, layout_row);
+					backend->copy(glyphs->numbers[tile_number], NULL, &number_rect);
+				} else if(tile.data == TILE_BOMB) {
+					const SDL_Rect inside_rect = layout_rect(layout.inside_cols, layout.inside_rows, layout_col, layout_row);
+					backend->copy(context->bomb, NULL, &inside_rect);
+				}
+			} 
+			else if (game->dead && tile.data == TILE_BOMB) 
+			{
+				const SDL_Rect inside_rect = layout_rect(layout.inside_cols, layout.inside_rows, layout_col, layout_row);
+				backend->copy(context->bomb, NULL, &inside_rect);
+			}
+			else 
+			{
+				render_filled_rect(backend, &bound_rect, 127, 127, 127);
+				if(tile.flagged) {
+					const SDL_Rect inside_rect = layout_rect(layout.inside_cols, layout.inside_rows, layout_col, layout_row);
+					backend->copy(context->flag, NULL, &inside_rect);
+				}
+			}
+
+			render_rect_with_color(backend, &bound_rect, 0, 0, 0);
+		}
+	}
+}
+
+// overview in the bottom right corner with the visible area outlined
+static void render_minimap(render_context* context)
+{
+	const camera& cam = context->cam;
+	const minimap& map = context->map;
+
+	const float texel_size = (float)MINIMAP_SIZE / std::max(map.tex_w, map.tex_h);
+	const int map_w = (int)(map.tex_w * texel_size);
+	const int map_h = (int)(map.tex_h * texel_size);
+
+	const SDL_Rect map_rect = {
+		.x = cam.viewport_w - map_w - MINIMAP_MARGIN,
+		.y = cam.viewport_h - map_h - MINIMAP_MARGIN,
+		.w = map_w,
+		.h = map_h
+	};
+
+	minimap_render(context->backend, &context->map, context->board, &map_rect);
+	render_rect_with_color(context->backend, &map_rect, 0, 0, 0);
+
+	const tile_range visible = camera_visible_tiles(cam, context->board);
+	const float tile_size = texel_size / map.block;
+	const SDL_Rect view_rect = {
+		.x = map_rect.x + (int)((visible.first_col - 1) * tile_size),
+		.y = map_rect.y + (int)((visible.first_row - 1) * tile_size),
+		.w = std::max(1, (int)((visible.last_col - visible.first_col + 1) * tile_size)),
+		.h = std::max(1, (int)((visible.last_row - visible.first_row + 1) * tile_size))
+	};
+	render_rect_with_color(context->backend, &view_rect, 0, 0, 255);
+}
+
+void render_frame(render_context* context)
+{
+	Minesweeper* board = context->board;
+	const camera& cam = context->cam;
+
+	// the lod texture tracks changes even while sprites are drawn so switching is instant
+	lod_mark_changes(&context->lod, board);
+	minimap_mark_changes(&context->map, board);
+	board->changed_tiles.clear();
+
+	context->backend->clear();
+
+	if(TILE_PITCH_X * camera_scale(cam) < LOD_TILE_PIXELS)
+		render_lod(context);
+	else
+		render_sprites(context);
+
+	// only useful when part of the board is off screen
+	const bool board_fits = camera_fit_zoom(cam, board) >= cam.zoom;
+	if(context->show_minimap && !board_fits)
+		render_minimap(context);
+
+	context->backend->present();
+}
+
+void latency_record(input_latency* latency, uint32_t input_ticks)
+{
+	const uint32_t elapsed = SDL_GetTicks() - input_ticks;
+
+	latency->samples++;
+	latency->total_ms += elapsed;
+	latency->max_ms = std::max(latency->max_ms, elapsed);
+}
+
+void latency_print(const input_latency* latency, const char* label)
+{
+	if(latency->samples == 0)
+		return;
+
+	printf("%s input latency: %llu frames with input, average %.2f ms, max %u ms\n", label,
+		(unsigned long long)latency->samples, (double)latency->total_ms / latency->samples, latency->max_ms);
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+
+#include "renderer.hpp"
+#include "minesweeper.hpp"
+#include "camera.hpp"
+#include "glyph_cache.hpp"
+#include "layout.hpp"
+#include "lod.hpp"
+#include "minimap.hpp"
+
+// everything needed to draw a board, owned by whichever thread renders
+struct render_context
+{
+	RenderBackend* backend = nullptr;
+
+	// the game itself, or a mirror fed by render commands when drawing on the render thread
+	Minesweeper* board = nullptr;
+	camera cam;
+	bool show_minimap = true;
+
+	render_texture bomb;
+	render_texture flag;
+	glyph_cache glyphs;
+	tile_layout layout;
+	lod_map lod;
+	minimap map;
+};
+
+// loads the sprites and builds the glyph atlas from font
+void render_context_init(render_context* context, RenderBackend* backend, TTF_Font* font);
+void render_context_destroy(render_context* context);
+
+// recreates the textures sized after the board, call whenever context->board is replaced
+void render_set_board(render_context* context, Minesweeper* board);
+
+// consumes context->board->changed_tiles and draws and presents one frame
+void render_frame(render_context* context);
+
+// time from an input event to the present of the first frame that includes it, in SDL ticks
+struct input_latency
+{
+	uint64_t samples = 0;
+	uint64_t total_ms = 0;
+	uint32_t max_ms = 0;
+};
+
+// input_ticks is the SDL event timestamp, call right after presenting
+void latency_record(input_latency* latency, uint32_t input_ticks);
+void latency_print(const input_latency* latency, const char* label);
@@ -0,0 +1,72 @@
+#include <atomic>
+
+#include "board_snapshot.hpp"
+
+// only the game thread hands out references, so once the count is down to 1 it stays there
+// the fence orders the last reader's accesses before the writes that follow
+template <typename T>
+static bool sole_owner(const std::shared_ptr<T>& pointer)
+{
+	if(pointer.use_count() != 1)
+		return false;
+
+	std::atomic_thread_fence(std::memory_order_acquire);
+	return true;
+}
+
+static size_t chunk_index(const snapshot_table& table, int row, int col)
+{
+	return (size_t)((row - 1) >> SNAPSHOT_CHUNK_SHIFT) * table.chunks_per_row + ((col - 1) >> SNAPSHOT_CHUNK_SHIFT);
+}
+
+static Tile& chunk_tile(snapshot_chunk& chunk, int row, int col)
+{
+	return chunk.tiles[(((row - 1) & (SNAPSHOT_CHUNK_SIZE - 1)) << SNAPSHOT_CHUNK_SHIFT) + ((col - 1) & (SNAPSHOT_CHUNK_SIZE - 1))];
+}
+
+void snapshot_reset(snapshot_source* source, const Minesweeper* game)
+{
+	std::shared_ptr<snapshot_table> table = std::make_shared<snapshot_table>();
+	table->width = game->width;
+	table->height = game->height;
+	table->chunks_per_row = (game->width + SNAPSHOT_CHUNK_SIZE - 1) >> SNAPSHOT_CHUNK_SHIFT;
+	table->dead = game->dead;
+
+	const int chunk_rows = (game->height + SNAPSHOT_CHUNK_SIZE - 1) >> SNAPSHOT_CHUNK_SHIFT;
+	table->chunks.resize((size_t)chunk_rows * table->chunks_per_row);
+	for(std::shared_ptr<snapshot_chunk>& chunk : table->chunks)
+		chunk = std::make_shared<snapshot_chunk>();
+
+	for(int row = 1; row <= game->height; row++)
+		for(int col = 1; col <= game->width; col++)
+			chunk_tile(*table->chunks[chunk_index(*table, row, col)], row, col) = game->tilemap[row][col];
+
+	// snapshots of the old board keep it alive on their own
+	source->table = std::move(table);
+}
+
+void snapshot_sync(snapshot_source* source, const Minesweeper* game)
+{
+	if(game->changed_tiles.empty() && game->dead == source->table->dead)
+		return;
+
+	// a snapshot holds the table, the copy shares every chunk until it's written
+	if(!sole_owner(source->table))
+		source->table = std::make_shared<snapshot_table>(*source->table);
+
+	snapshot_table& table = *source->table;
+	table.dead = game->dead;
+
+	for(const auto& [row, col] : game->changed_tiles) {
+		std::shared_ptr<snapshot_chunk>& chunk = table.chunks[chunk_index(table, row, col)];
+		if(!sole_owner(chunk))
+			chunk = std::make_shared<snapshot_chunk>(*chunk);
+
+		chunk_tile(*chunk, row, col) = game->tilemap[row][col];
+	}
+}
+
+board_snapshot snapshot_take(const snapshot_source* source)
+{
+	return { source->table };
+}
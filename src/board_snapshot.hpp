@@ -0,0 +1,57 @@
+#pragma once
+#include <memory>
+#include <vector>
+
+#include "minesweeper.hpp"
+
+// 64x64 tiles per chunk, a click that opens a few tiles copies 12 KB at most
+constexpr int SNAPSHOT_CHUNK_SHIFT = 6;
+constexpr int SNAPSHOT_CHUNK_SIZE = 1 << SNAPSHOT_CHUNK_SHIFT;
+
+struct snapshot_chunk
+{
+	Tile tiles[SNAPSHOT_CHUNK_SIZE * SNAPSHOT_CHUNK_SIZE];
+};
+
+// chunks are shared between the live table and every snapshot taken since they last changed
+struct snapshot_table
+{
+	int width = 0, height = 0;
+	int chunks_per_row = 0;
+	bool dead = false;
+	std::vector<std::shared_ptr<snapshot_chunk>> chunks;
+};
+
+// a frozen copy of the board, it never changes and can be read from any thread without locking
+struct board_snapshot
+{
+	std::shared_ptr<const snapshot_table> table;
+
+	int width() const { return table->width; }
+	int height() const { return table->height; }
+	bool dead() const { return table->dead; }
+
+	// 1-based like the tilemap
+	const Tile& tile(int row, int col) const
+	{
+		const int chunk_row = (row - 1) >> SNAPSHOT_CHUNK_SHIFT, chunk_col = (col - 1) >> SNAPSHOT_CHUNK_SHIFT;
+		const snapshot_chunk& chunk = *table->chunks[(size_t)chunk_row * table->chunks_per_row + chunk_col];
+		return chunk.tiles[(((row - 1) & (SNAPSHOT_CHUNK_SIZE - 1)) << SNAPSHOT_CHUNK_SHIFT) + ((col - 1) & (SNAPSHOT_CHUNK_SIZE - 1))];
+	}
+};
+
+// copy-on-write mirror of a board, owned by the game thread
+// a snapshot shares the current table, the next sync copies the table's pointers and then only the chunks it writes
+struct snapshot_source
+{
+	std::shared_ptr<snapshot_table> table;
+};
+
+// copies the whole board, call again whenever it's replaced
+void snapshot_reset(snapshot_source* source, const Minesweeper* game);
+
+// call every frame before changed_tiles is cleared
+void snapshot_sync(snapshot_source* source, const Minesweeper* game);
+
+// O(1), the board as of the last sync
+board_snapshot snapshot_take(const snapshot_source* source);
@@ -0,0 +1,309 @@
+#include <iostream>
+#include <cstdlib>
+
+#include "bot_server.hpp"
+
+#if defined(_WIN32) || defined(__EMSCRIPTEN__)
+
+int run_bot_load(const char*, int, int, int)
+{
+	std::cout << "The bot server isn't supported on this platform\n";
+	return EXIT_FAILURE;
+}
+
+#else
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "bot_protocol.hpp"
+#include "mine_oracle.hpp"
+
+// one in this many requests asks for the whole board instead of opening a tile
+constexpr uint32_t LOAD_VIEW_INTERVAL = 16;
+
+struct load_session
+{
+	int fd = -1;
+	uint32_t width = 0, height = 0;
+	uint64_t rng = 0;
+
+	std::vector<uint8_t> input;
+	size_t input_size = 0;
+	std::vector<uint8_t> output;
+	size_t output_start = 0, output_end = 0;
+	bool want_write = false;
+
+	// send times by tag, responses come back in order so in flight tags never collide
+	std::vector<uint64_t> sent_ns;
+	uint32_t next_tag = 0;
+	int in_flight = 0;
+	int sent = 0;
+	int answered = 0;
+	bool new_game_next = false;
+};
+
+static uint64_t now_ns()
+{
+	return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static uint64_t next_random(load_session* session)
+{
+	session->rng += 0x9e3779b97f4a7c15ull;
+	return oracle_mix(session->rng);
+}
+
+static int connect_to(const char* path)
+{
+	sockaddr_un address = {};
+	address.sun_family = AF_UNIX;
+	std::strncpy(address.sun_path, path, sizeof(address.sun_path) - 1);
+
+	const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if(fd < 0)
+		return -1;
+	if(connect(fd, (sockaddr*)&address, sizeof(address)) != 0) {
+		close(fd);
+		return -1;
+	}
+
+	return fd;
+}
+
+static bool send_all(int fd, const void* data, size_t size)
+{
+	const uint8_t* bytes = (const uint8_t*)data;
+	while(size > 0) {
+		const ssize_t sent = send(fd, bytes, size, MSG_NOSIGNAL);
+		if(sent <= 0)
+			return false;
+		bytes += sent;
+		size -= sent;
+	}
+	return true;
+}
+
+static bool receive_all(int fd, void* data, size_t size)
+{
+	uint8_t* bytes = (uint8_t*)data;
+	while(size > 0) {
+		const ssize_t received = recv(fd, bytes, size, 0);
+		if(received <= 0)
+			return false;
+		bytes += received;
+		size -= received;
+	}
+	return true;
+}
+
+// starts a game the blocking way before the session goes non-blocking, the response says how big the board is
+static bool start_session(load_session* session, const char* path, int index, int pipeline)
+{
+	session->fd = connect_to(path);
+	if(session->fd < 0)
+		return false;
+
+	const bot_request request = { .tag = 0, .op = BOT_NEW_GAME, .reserved = {}, .row = 0, .col = 0 };
+	bot_response response;
+	if(!send_all(session->fd, &request, sizeof(request)) || !receive_all(session->fd, &response, sizeof(response)) || response.status != BOT_OK)
+		return false;
+
+	session->width = response.width;
+	session->height = response.height;
+	session->rng = oracle_mix((uint64_t)index);
+
+	// a whole pipeline of opens that each change every tile still fits
+	const size_t tiles = (size_t)response.width * response.height;
+	session->input.resize((sizeof(bot_response) + tiles * sizeof(uint32_t)) * pipeline);
+	session->output.resize(sizeof(bot_request) * pipeline);
+	session->sent_ns.resize(pipeline);
+	session->next_tag = 1;
+	return true;
+}
+
+static void queue_requests(load_session* session, int pipeline, int requests)
+{
+	if(session->output_start == session->output_end)
+		session->output_start = session->output_end = 0;
+
+	const uint64_t now = now_ns();
+	while(session->in_flight < pipeline && session->sent < requests && session->output_end + sizeof(bot_request) <= session->output.size()) {
+		// the opens already in flight went to the lost board, the new game waits until they're answered
+		if(session->new_game_next && session->in_flight > 0)
+			break;
+
+		bot_request request = { .tag = session->next_tag++, .op = BOT_OPEN, .reserved = {}, .row = 0, .col = 0 };
+		const uint64_t random = next_random(session);
+		if(session->new_game_next) {
+			request.op = BOT_NEW_GAME;
+			session->new_game_next = false;
+		}
+		else if(random % LOAD_VIEW_INTERVAL == 0) {
+			request.op = BOT_VIEW;
+		}
+		else {
+			request.row = (uint32_t)((random >> 8) % session->height) + 1;
+			request.col = (uint32_t)((random >> 40) % session->width) + 1;
+		}
+
+		session->sent_ns[request.tag % pipeline] = now;
+		std::memcpy(session->output.data() + session->output_end, &request, sizeof(request));
+		session->output_end += sizeof(request);
+		session->in_flight++;
+		session->sent++;
+	}
+}
+
+// returns false if the connection broke
+static bool flush_requests(int epoll_fd, load_session* session)
+{
+	while(session->output_start < session->output_end) {
+		const ssize_t sent = send(session->fd, session->output.data() + session->output_start, session->output_end - session->output_start, MSG_NOSIGNAL);
+		if(sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+			break;
+		if(sent <= 0)
+			return false;
+
+		session->output_start += sent;
+	}
+
+	const bool want_write = session->output_start != session->output_end;
+	if(want_write != session->want_write) {
+		epoll_event event = { .events = EPOLLIN | (want_write ? EPOLLOUT : 0u), .data = { .ptr = session } };
+		epoll_ctl(epoll_fd, EPOLL_CTL_MOD, session->fd, &event);
+		session->want_write = want_write;
+	}
+
+	return true;
+}
+
+// reads whatever arrived and records a latency for every complete response, returns false if the connection broke
+static bool read_responses(load_session* session, int pipeline, uint32_t* latencies, size_t* latency_count)
+{
+	for(;;) {
+		const ssize_t received = recv(session->fd, session->input.data() + session->input_size, session->input.size() - session->input_size, 0);
+		if(received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+			break;
+		if(received <= 0)
+			return false;
+
+		session->input_size += received;
+		if(session->input_size < session->input.size())
+			break;
+	}
+
+	const uint64_t now = now_ns();
+	size_t offset = 0;
+	while(session->input_size - offset >= sizeof(bot_response)) {
+		bot_response response;
+		std::memcpy(&response, session->input.data() + offset, sizeof(response));
+		if(session->input_size - offset < sizeof(response) + response.payload_size)
+			break;
+
+		offset += sizeof(response) + response.payload_size;
+		latencies[(*latency_count)++] = (uint32_t)std::min<uint64_t>(now - session->sent_ns[response.tag % pipeline], UINT32_MAX);
+		session->in_flight--;
+		session->answered++;
+
+		if(response.dead || response.won)
+			session->new_game_next = true;
+	}
+
+	std::memmove(session->input.data(), session->input.data() + offset, session->input_size - offset);
+	session->input_size -= offset;
+	return true;
+}
+
+static double percentile_us(const std::vector<uint32_t>& sorted, double fraction)
+{
+	const size_t index = std::min(sorted.size() - 1, (size_t)(fraction * (double)sorted.size()));
+	return sorted[index] / 1000.0;
+}
+
+int run_bot_load(const char* path, int sessions, int requests, int pipeline)
+{
+	std::vector<load_session> clients(sessions);
+	for(int i = 0; i < sessions; i++) {
+		if(!start_session(&clients[i], path, i, pipeline)) {
+			std::cout << "Couldn't start a session on " << path << ", ERROR: " << std::strerror(errno) << "\n";
+			return EXIT_FAILURE;
+		}
+	}
+
+	const int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	for(load_session& session : clients) {
+		fcntl(session.fd, F_SETFL, fcntl(session.fd, F_GETFL) | O_NONBLOCK);
+		epoll_event event = { .events = EPOLLIN, .data = { .ptr = &session } };
+		epoll_ctl(epoll_fd, EPOLL_CTL_ADD, session.fd, &event);
+	}
+
+	// every latency has a slot before the clock starts
+	std::vector<uint32_t> latencies((size_t)sessions * requests);
+	size_t latency_count = 0;
+
+	printf("%d sessions, %d requests each, %d in flight per session, %ux%u boards\n",
+		sessions, requests, pipeline, clients[0].width, clients[0].height);
+	fflush(stdout);
+
+	const auto start = std::chrono::steady_clock::now();
+
+	for(load_session& session : clients) {
+		queue_requests(&session, pipeline, requests);
+		if(!flush_requests(epoll_fd, &session)) {
+			std::cout << "Lost the connection to " << path << "\n";
+			return EXIT_FAILURE;
+		}
+	}
+
+	int finished = 0;
+	std::vector<epoll_event> events(std::max(sessions, 1));
+	while(finished < sessions) {
+		const int count = epoll_wait(epoll_fd, events.data(), (int)events.size(), -1);
+		for(int i = 0; i < count; i++) {
+			load_session* session = (load_session*)events[i].data.ptr;
+			const bool was_done = session->answered == requests;
+
+			bool open = true;
+			if(events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+				open = read_responses(session, pipeline, latencies.data(), &latency_count);
+			if(open) {
+				queue_requests(session, pipeline, requests);
+				open = flush_requests(epoll_fd, session);
+			}
+
+			if(!open) {
+				std::cout << "Lost the connection to " << path << "\n";
+				return EXIT_FAILURE;
+			}
+
+			if(!was_done && session->answered == requests)
+				finished++;
+		}
+	}
+
+	const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	for(load_session& session : clients)
+		close(session.fd);
+	close(epoll_fd);
+
+	latencies.resize(latency_count);
+	std::sort(latencies.begin(), latencies.end());
+	printf("%zu requests in %.2fs, %.0f requests/s\n", latency_count, seconds, latency_count / seconds);
+	printf("latency p50 %.1fus, p99 %.1fus, p99.9 %.1fus, max %.1fus\n",
+		percentile_us(latencies, 0.50), percentile_us(latencies, 0.99), percentile_us(latencies, 0.999), latencies.back() / 1000.0);
+	return EXIT_SUCCESS;
+}
+
+#endif
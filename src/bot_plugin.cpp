@@ -0,0 +1,204 @@
+#include <iostream>
+#include <cstdlib>
+
+#include "bot_plugin.hpp"
+
+#if defined(_WIN32) || defined(__EMSCRIPTEN__)
+
+bool bot_plugin_load(bot_plugin*, const char*)
+{
+	std::cout << "Bot plugins aren't supported on this platform\n";
+	return false;
+}
+
+void bot_plugin_unload(bot_plugin*)
+{
+}
+
+int run_bot_plugin(const char*, int, int, int, int)
+{
+	std::cout << "Bot plugins aren't supported on this platform\n";
+	return EXIT_FAILURE;
+}
+
+#else
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include <dlfcn.h>
+
+#include "minesweeper.hpp"
+#include "mine_oracle.hpp"
+
+// moves a plugin can return from one call
+constexpr uint32_t BOT_PLUGIN_MOVE_CAPACITY = 256;
+
+// calls with no room for moves, timed together for the cost of crossing into the plugin
+constexpr int BOT_PLUGIN_CALIBRATION_CALLS = 1000000;
+
+bool bot_plugin_load(bot_plugin* plugin, const char* path)
+{
+	plugin->library = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+	if(!plugin->library) {
+		std::cout << "Couldn't load " << path << ", ERROR: " << dlerror() << "\n";
+		return false;
+	}
+
+	ms_bot_entry entry = reinterpret_cast<ms_bot_entry>(dlsym(plugin->library, MS_BOT_ENTRY));
+	plugin->api = entry ? entry() : nullptr;
+
+	const ms_bot_plugin* api = plugin->api;
+	if(!api || api->api_version != MS_BOT_API_VERSION || !api->create || !api->destroy || !api->new_game || !api->next_moves) {
+		std::cout << path << " isn't a bot plugin for version " << MS_BOT_API_VERSION << " (it has to export " << MS_BOT_ENTRY << ")\n";
+		bot_plugin_unload(plugin);
+		return false;
+	}
+
+	return true;
+}
+
+void bot_plugin_unload(bot_plugin* plugin)
+{
+	if(plugin->library)
+		dlclose(plugin->library);
+
+	plugin->library = nullptr;
+	plugin->api = nullptr;
+}
+
+struct plugin_results
+{
+	uint64_t won = 0, lost = 0, gave_up = 0;
+	uint64_t calls = 0, moves = 0, bad_moves = 0;
+	std::chrono::steady_clock::duration in_plugin{}, in_simulator{};
+};
+
+// plays until the game is lost or won or the bot stops changing the board
+static void play_game(const ms_bot_plugin* api, void* bot, Minesweeper* game, ms_board_view* view, ms_move* moves, plugin_results* results)
+{
+	const uint32_t tiles = view->width * view->height;
+	const uint32_t safe_tiles = tiles - view->bombcount;
+	uint32_t opened = 0;
+
+	view->dead = 0;
+	api->new_game(bot, view);
+
+	auto now = std::chrono::steady_clock::now();
+	for(;;) {
+		const uint32_t count = api->next_moves(bot, view, moves, BOT_PLUGIN_MOVE_CAPACITY);
+		const auto returned = std::chrono::steady_clock::now();
+		results->in_plugin += returned - now;
+		results->calls++;
+
+		if(count == 0 || count > BOT_PLUGIN_MOVE_CAPACITY) {
+			results->gave_up++;
+			return;
+		}
+
+		// changed_tiles keeps its capacity, so after the first few calls this doesn't allocate either
+		game->changed_tiles.clear();
+		for(uint32_t i = 0; i < count; i++) {
+			const ms_move move = moves[i];
+			if(move.tile >= tiles || (move.kind != MS_MOVE_OPEN && move.kind != MS_MOVE_FLAG)) {
+				results->bad_moves++;
+				continue;
+			}
+
+			const int row = (int)(move.tile / view->width) + 1, col = (int)(move.tile % view->width) + 1;
+			if(move.kind == MS_MOVE_FLAG) {
+				game->flag_tile(row, col);
+				continue;
+			}
+
+			const size_t changed = game->changed_tiles.size();
+			const bool was_dead = game->dead;
+			game->open_tile(row, col);
+			opened += (uint32_t)(game->changed_tiles.size() - changed) - (game->dead && !was_dead);
+		}
+
+		results->moves += count;
+		view->dead = game->dead;
+
+		now = std::chrono::steady_clock::now();
+		results->in_simulator += now - returned;
+
+		if(game->dead) {
+			results->lost++;
+			return;
+		}
+
+		if(opened == safe_tiles) {
+			results->won++;
+			return;
+		}
+
+		if(game->changed_tiles.empty()) {
+			results->gave_up++;
+			return;
+		}
+	}
+}
+
+int run_bot_plugin(const char* path, int width, int height, int bombcount, int games)
+{
+	bot_plugin plugin;
+	if(!bot_plugin_load(&plugin, path))
+		return EXIT_FAILURE;
+	const ms_bot_plugin* api = plugin.api;
+
+	// every plugin plays the same boards, so runs can be compared
+	Minesweeper game(width, height, bombcount, oracle_mix(1));
+	game.attach_view();
+
+	ms_board_view view = {
+		.tiles = game.view(),
+		.width = (uint32_t)width,
+		.height = (uint32_t)height,
+		.bombcount = (uint32_t)game.bomb_count(),
+		.dead = 0,
+	};
+
+	void* bot = api->create(&view);
+	if(!bot) {
+		std::cout << "The plugin couldn't create a bot\n";
+		bot_plugin_unload(&plugin);
+		return EXIT_FAILURE;
+	}
+
+	std::vector<ms_move> moves(BOT_PLUGIN_MOVE_CAPACITY);
+	plugin_results results;
+
+	const auto start = std::chrono::steady_clock::now();
+	for(int i = 0; i < games; i++) {
+		if(i > 0)
+			game.new_game(oracle_mix((uint64_t)i + 1));
+		play_game(api, bot, &game, &view, moves.data(), &results);
+	}
+	const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	const auto calibration_start = std::chrono::steady_clock::now();
+	uint64_t returned = 0;
+	for(int i = 0; i < BOT_PLUGIN_CALIBRATION_CALLS; i++)
+		returned += api->next_moves(bot, &view, moves.data(), 0);
+	const double call_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - calibration_start).count() / BOT_PLUGIN_CALIBRATION_CALLS;
+
+	api->destroy(bot);
+	printf("%s: %d games of %dx%d with %d bombs in %.2fs, %llu won, %llu lost, %llu given up\n",
+		api->name ? api->name : path, games, width, height, game.bomb_count(), seconds,
+		(unsigned long long)results.won, (unsigned long long)results.lost, (unsigned long long)results.gave_up);
+
+	const double plugin_ns = std::chrono::duration<double, std::nano>(results.in_plugin).count();
+	const double simulator_ns = std::chrono::duration<double, std::nano>(results.in_simulator).count();
+	printf("%llu calls, %llu moves (%llu invalid), %.1f ns per call in the plugin, %.1f ns per move applying it\n",
+		(unsigned long long)results.calls, (unsigned long long)results.moves, (unsigned long long)results.bad_moves,
+		plugin_ns / std::max<uint64_t>(results.calls, 1), simulator_ns / std::max<uint64_t>(results.moves, 1));
+	printf("calling into the plugin costs %.1f ns%s\n", call_ns, returned != 0 ? " (but it returned moves with no room for them)" : "");
+
+	bot_plugin_unload(&plugin);
+	return EXIT_SUCCESS;
+}
+
+#endif
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "bot_plugin_api.h"
+
+struct bot_plugin
+{
+	void* library = nullptr;
+	const ms_bot_plugin* api = nullptr;
+};
+
+// opens the shared object and checks its entry point and version, prints why on failure
+bool bot_plugin_load(bot_plugin* plugin, const char* path);
+void bot_plugin_unload(bot_plugin* plugin);
+
+// lets the plugin play games boards of the given size on one thread, then prints results and the cost of a call
+// returns the process exit code
+int run_bot_plugin(const char* path, int width, int height, int bombcount, int games);
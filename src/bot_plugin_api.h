@@ -0,0 +1,59 @@
+#pragma once
+#include <stdint.h>
+
+/* C ABI between the simulator and bots built as shared objects, loaded with --bot-plugin=path
+ * a plugin exports MS_BOT_ENTRY returning a table of function pointers that stays valid until it's unloaded
+ * nothing in here allocates or copies per move, the view points at the board the simulator plays on */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MS_BOT_API_VERSION 1
+#define MS_BOT_ENTRY "minesweeper_bot_plugin"
+
+/* one byte per tile, same as TileView: 0-8 open with that many mines around */
+#define MS_TILE_CLOSED 9
+#define MS_TILE_FLAGGED 10
+#define MS_TILE_MINE 11
+
+/* owned by the simulator, tiles is updated in place as moves are applied and is only valid during a call */
+typedef struct ms_board_view
+{
+	const uint8_t* tiles; /* width * height, row by row */
+	uint32_t width, height;
+	uint32_t bombcount;
+	uint32_t dead;
+} ms_board_view;
+
+#define MS_MOVE_OPEN 0
+#define MS_MOVE_FLAG 1 /* toggles, flagging a flagged tile removes the flag */
+
+typedef struct ms_move
+{
+	uint32_t tile; /* row * width + col, 0-based */
+	uint32_t kind;
+} ms_move;
+
+typedef struct ms_bot_plugin
+{
+	uint32_t api_version; /* MS_BOT_API_VERSION the plugin was built against */
+	const char* name;
+
+	/* once per loaded plugin, the view has the size every game will have, returns the bot's state */
+	void* (*create)(const ms_board_view* view);
+	void (*destroy)(void* bot);
+
+	/* a fresh board is in the view */
+	void (*new_game)(void* bot, const ms_board_view* view);
+
+	/* writes up to capacity moves and returns how many, they're applied in order before the next call
+	 * returning 0 gives up the game, a call with capacity 0 must return 0 right away (it times the call itself) */
+	uint32_t (*next_moves)(void* bot, const ms_board_view* view, ms_move* moves, uint32_t capacity);
+} ms_bot_plugin;
+
+typedef const ms_bot_plugin* (*ms_bot_entry)(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,44 @@
+#pragma once
+#include <cstdint>
+
+// fixed size little-endian frames over a Unix domain socket, a client can send any number of requests
+// before reading responses and gets them back in order
+// every connection plays its own board of the size the server was started with
+
+enum bot_op : uint8_t
+{
+	BOT_NEW_GAME = 0, // row and col are ignored, the payload is empty
+	BOT_OPEN = 1,     // the payload is one uint32 per changed tile, index << 4 | TileView
+	BOT_FLAG = 2,
+	BOT_VIEW = 3,     // the payload is the whole board, one TileView byte per tile row by row
+};
+
+enum bot_status : uint8_t
+{
+	BOT_OK = 0,
+	BOT_BAD_REQUEST = 1, // unknown op or a tile off the board, nothing changed
+};
+
+constexpr int BOT_CHANGE_VIEW_BITS = 4;
+
+struct bot_request
+{
+	uint32_t tag; // echoed back, lets a pipelining client match responses
+	uint8_t op;
+	uint8_t reserved[3];
+	uint32_t row; // 1-based like the tilemap
+	uint32_t col;
+};
+
+struct bot_response
+{
+	uint32_t tag;
+	uint8_t status;
+	uint8_t dead;
+	uint8_t won;
+	uint8_t reserved;
+	uint32_t width, height;
+	uint32_t payload_size; // in bytes, follows the response
+};
+
+static_assert(sizeof(bot_request) == 16 && sizeof(bot_response) == 20);
@@ -0,0 +1,399 @@
+#include <iostream>
+#include <cstdlib>
+
+#include "bot_server.hpp"
+
+#if defined(_WIN32) || defined(__EMSCRIPTEN__)
+
+int run_bot_server(const char*, int, int, int)
+{
+	std::cout << "The bot server isn't supported on this platform\n";
+	return EXIT_FAILURE;
+}
+
+#else
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include <errno.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "bot_protocol.hpp"
+#include "minesweeper.hpp"
+#include "mine_oracle.hpp"
+
+constexpr int BOT_MAX_EVENTS = 256;
+constexpr int BOT_LISTEN_BACKLOG = 1024;
+constexpr int BOT_POLL_MS = 200;
+
+// room for this many bytes of small responses on top of the biggest single one
+constexpr size_t BOT_BUFFER_SLACK = 64 * 1024;
+
+static volatile sig_atomic_t g_bot_stop = 0;
+
+static void stop_on_signal(int)
+{
+	g_bot_stop = 1;
+}
+
+struct bot_session
+{
+	int fd;
+	Minesweeper game;
+	uint32_t opened = 0;
+
+	// both buffers are sized when the connection is accepted and never grow
+	std::vector<uint8_t> input;
+	size_t input_size = 0;
+	std::vector<uint8_t> output;
+	size_t output_start = 0, output_end = 0;
+
+	// the client shut down its side, what it sent is still answered before the connection closes
+	bool eof = false;
+
+	// what epoll currently reports for the connection, and where it sits in the server's live list
+	uint32_t events = EPOLLIN;
+	size_t slot = 0;
+
+	bot_session(int fd, int width, int height, int bombcount, uint64_t seed, size_t output_capacity)
+		: fd(fd), game(width, height, bombcount, seed), input(BOT_BUFFER_SLACK), output(output_capacity)
+	{
+		game.attach_view();
+	}
+};
+
+struct bot_server
+{
+	int epoll_fd = -1;
+	int listen_fd = -1;
+	int width = 0, height = 0, bombcount = 0;
+
+	// the biggest response, an open that changes every tile
+	size_t max_response = 0;
+
+	// every open connection, so they can be closed on shutdown
+	std::vector<bot_session*> live;
+
+	uint64_t seed = 0;
+	uint64_t games = 0;
+	uint64_t sessions = 0;
+	uint64_t requests = 0;
+};
+
+static uint64_t next_seed(bot_server* server)
+{
+	return oracle_mix(server->seed + ++server->games);
+}
+
+static bool is_won(const bot_session* session)
+{
+	return !session->game.dead && session->opened == (uint32_t)(session->game.width * session->game.height - session->game.bomb_count());
+}
+
+// writes the response straight into the session's output, the caller made sure max_response bytes are free
+static void handle_request(bot_server* server, bot_session* session, const bot_request& request)
+{
+	Minesweeper& game = session->game;
+	uint8_t* out = session->output.data() + session->output_end;
+	uint8_t* payload = out + sizeof(bot_response);
+	uint32_t payload_size = 0;
+	uint8_t status = BOT_OK;
+
+	const bool on_board = request.row >= 1 && request.col >= 1 && request.row <= (uint32_t)game.height && request.col <= (uint32_t)game.width;
+
+	switch(request.op)
+	{
+		case BOT_NEW_GAME:
+			game.new_game(next_seed(server));
+			session->opened = 0;
+			break;
+
+		case BOT_OPEN:
+		case BOT_FLAG:
+		{
+			if(!on_board) {
+				status = BOT_BAD_REQUEST;
+				break;
+			}
+
+			const bool was_dead = game.dead;
+			game.changed_tiles.clear();
+			if(request.op == BOT_OPEN)
+				game.open_tile(request.row, request.col);
+			else
+				game.flag_tile(request.row, request.col);
+
+			const uint8_t* view = game.view();
+			for(const auto& [row, col] : game.changed_tiles) {
+				const uint32_t index = (uint32_t)(row - 1) * game.width + (col - 1);
+				const uint32_t change = index << BOT_CHANGE_VIEW_BITS | view[index];
+				std::memcpy(payload + payload_size, &change, sizeof(change));
+				payload_size += sizeof(change);
+			}
+
+			if(request.op == BOT_OPEN)
+				session->opened += (uint32_t)game.changed_tiles.size() - (game.dead && !was_dead);
+			game.changed_tiles.clear();
+			break;
+		}
+
+		case BOT_VIEW:
+			payload_size = (uint32_t)((size_t)game.width * game.height);
+			std::memcpy(payload, game.view(), payload_size);
+			break;
+
+		default:
+			status = BOT_BAD_REQUEST;
+			break;
+	}
+
+	const bot_response response = {
+		.tag = request.tag,
+		.status = status,
+		.dead = game.dead,
+		.won = is_won(session),
+		.reserved = 0,
+		.width = (uint32_t)game.width,
+		.height = (uint32_t)game.height,
+		.payload_size = payload_size,
+	};
+	std::memcpy(out, &response, sizeof(response));
+
+	session->output_end += sizeof(response) + payload_size;
+	server->requests++;
+}
+
+static void close_session(bot_server* server, bot_session* session)
+{
+	bot_session* last = server->live.back();
+	last->slot = session->slot;
+	server->live[session->slot] = last;
+	server->live.pop_back();
+
+	epoll_ctl(server->epoll_fd, EPOLL_CTL_DEL, session->fd, nullptr);
+	close(session->fd);
+	delete session;
+}
+
+// answers every complete request that fits in the output, the rest waits until it drains
+static void process_input(bot_server* server, bot_session* session)
+{
+	size_t offset = 0;
+	while(session->input_size - offset >= sizeof(bot_request)) {
+		if(session->output.size() - session->output_end < server->max_response) {
+			if(session->output_start == 0)
+				break;
+
+			// move what's still unsent to the front to make room
+			std::memmove(session->output.data(), session->output.data() + session->output_start, session->output_end - session->output_start);
+			session->output_end -= session->output_start;
+			session->output_start = 0;
+			continue;
+		}
+
+		bot_request request;
+		std::memcpy(&request, session->input.data() + offset, sizeof(request));
+		offset += sizeof(request);
+		handle_request(server, session, request);
+	}
+
+	std::memmove(session->input.data(), session->input.data() + offset, session->input_size - offset);
+	session->input_size -= offset;
+}
+
+// returns false if the connection broke
+static bool flush_output(bot_session* session)
+{
+	while(session->output_start < session->output_end) {
+		const ssize_t sent = send(session->fd, session->output.data() + session->output_start, session->output_end - session->output_start, MSG_NOSIGNAL);
+		if(sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+			break;
+		if(sent <= 0)
+			return false;
+
+		session->output_start += sent;
+	}
+
+	if(session->output_start == session->output_end)
+		session->output_start = session->output_end = 0;
+
+	return true;
+}
+
+// only asks for what the session can act on, epoll is level triggered so anything else returns every wait
+// writability while output is waiting, readability while the input has room, a full input only empties once the output drains
+static void update_events(bot_server* server, bot_session* session)
+{
+	const uint32_t events = (!session->eof && session->input_size < session->input.size() ? EPOLLIN : 0u) |
+		(session->output_start != session->output_end ? EPOLLOUT : 0u);
+	if(events == session->events)
+		return;
+
+	epoll_event event = { .events = events, .data = { .ptr = session } };
+	epoll_ctl(server->epoll_fd, EPOLL_CTL_MOD, session->fd, &event);
+	session->events = events;
+}
+
+// answers and sends until the requests run out or the client stops reading
+// returns false if the connection broke, or the client shut down its side and has every answer
+// requests left waiting for room have nothing else to wake them once the output drains, so they go out in the same pass
+static bool serve_session(bot_server* server, bot_session* session)
+{
+	for(;;) {
+		const size_t waiting = session->input_size;
+		process_input(server, session);
+		if(!flush_output(session))
+			return false;
+
+		// EPOLLOUT picks it up from here if the output is still backed up
+		if(session->input_size == waiting || session->output_end != 0) {
+			if(session->eof && session->output_end == 0)
+				return false;
+
+			update_events(server, session);
+			return true;
+		}
+	}
+}
+
+// returns false if the connection broke, a client that only shut down its side still gets its answers
+static bool read_input(bot_session* session)
+{
+	while(!session->eof && session->input_size < session->input.size()) {
+		const ssize_t received = recv(session->fd, session->input.data() + session->input_size, session->input.size() - session->input_size, 0);
+		if(received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+			return true;
+		if(received < 0)
+			return false;
+
+		if(received == 0) {
+			session->eof = true;
+			return true;
+		}
+
+		session->input_size += received;
+	}
+
+	return true;
+}
+
+static void accept_sessions(bot_server* server)
+{
+	for(;;) {
+		const int fd = accept4(server->listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+		if(fd < 0)
+			return;
+
+		bot_session* session = new bot_session(fd, server->width, server->height, server->bombcount, next_seed(server),
+			server->max_response + BOT_BUFFER_SLACK);
+
+		epoll_event event = { .events = EPOLLIN, .data = { .ptr = session } };
+		if(epoll_ctl(server->epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0) {
+			close(fd);
+			delete session;
+			continue;
+		}
+
+		session->slot = server->live.size();
+		server->live.push_back(session);
+		server->sessions++;
+	}
+}
+
+int run_bot_server(const char* path, int width, int height, int bombcount)
+{
+	sockaddr_un address = {};
+	address.sun_family = AF_UNIX;
+	if(std::strlen(path) >= sizeof(address.sun_path)) {
+		std::cout << "Socket path is too long: " << path << "\n";
+		return EXIT_FAILURE;
+	}
+	std::strcpy(address.sun_path, path);
+
+	// changes carry the tile index above the view bits of a 32 bit word
+	if((uint64_t)width * height > (1ull << (32 - BOT_CHANGE_VIEW_BITS))) {
+		std::cout << "Boards over " << (1ull << (32 - BOT_CHANGE_VIEW_BITS)) << " tiles can't be served\n";
+		return EXIT_FAILURE;
+	}
+
+	bot_server server;
+	server.width = width;
+	server.height = height;
+	server.bombcount = bombcount;
+	server.max_response = sizeof(bot_response) + (size_t)width * height * sizeof(uint32_t);
+	server.seed = ((uint64_t)std::random_device()() << 32) | std::random_device()();
+
+	// a socket file left behind by a previous run would make bind fail, but one a server still listens on is left alone
+	const int probe_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if(probe_fd >= 0) {
+		const bool running = connect(probe_fd, (sockaddr*)&address, sizeof(address)) == 0;
+		const bool stale = !running && errno == ECONNREFUSED;
+		close(probe_fd);
+
+		if(running) {
+			std::cout << "A server is already listening on " << path << "\n";
+			return EXIT_FAILURE;
+		}
+		if(stale)
+			unlink(path);
+	}
+
+	server.listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if(server.listen_fd < 0 || bind(server.listen_fd, (sockaddr*)&address, sizeof(address)) != 0 || listen(server.listen_fd, BOT_LISTEN_BACKLOG) != 0) {
+		std::cout << "Couldn't listen on " << path << ", ERROR: " << std::strerror(errno) << "\n";
+		return EXIT_FAILURE;
+	}
+
+	server.epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	epoll_event listen_event = { .events = EPOLLIN, .data = { .ptr = nullptr } };
+	epoll_ctl(server.epoll_fd, EPOLL_CTL_ADD, server.listen_fd, &listen_event);
+
+	std::signal(SIGINT, stop_on_signal);
+	std::signal(SIGTERM, stop_on_signal);
+	printf("Serving %dx%d boards with %d bombs on %s\n", width, height, bombcount, path);
+	fflush(stdout);
+
+	epoll_event events[BOT_MAX_EVENTS];
+	while(!g_bot_stop) {
+		const int count = epoll_wait(server.epoll_fd, events, BOT_MAX_EVENTS, BOT_POLL_MS);
+
+		for(int i = 0; i < count; i++) {
+			bot_session* session = (bot_session*)events[i].data.ptr;
+			if(!session) {
+				accept_sessions(&server);
+				continue;
+			}
+
+			bool open = true;
+			if(events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+				open = read_input(session);
+			if(open)
+				open = serve_session(&server, session);
+
+			if(!open)
+				close_session(&server, session);
+		}
+	}
+
+	while(!server.live.empty())
+		close_session(&server, server.live.back());
+
+	close(server.listen_fd);
+	close(server.epoll_fd);
+	unlink(path);
+
+	printf("\nServed %llu sessions, %llu requests, %llu games\n",
+		(unsigned long long)server.sessions, (unsigned long long)server.requests, (unsigned long long)server.games);
+	return EXIT_SUCCESS;
+}
+
+#endif
@@ -0,0 +1,9 @@
+#pragma once
+
+// serves one board of the given size per connection on a Unix domain socket at path, see bot_protocol.hpp
+// runs until interrupted and returns the process exit code
+int run_bot_server(const char* path, int width, int height, int bombcount);
+
+// keeps pipeline requests in flight on each of sessions connections until each has had requests answered
+// then prints throughput and latency percentiles, returns the process exit code
+int run_bot_load(const char* path, int sessions, int requests, int pipeline);
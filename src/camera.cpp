@@ -0,0 +1,118 @@
+#include <cmath>
+#include <algorithm>
+
+#include "camera.hpp"
+
+float board_world_width(const Minesweeper* game)
+{
+	return 2 * OUTSIDE_PADDING + game->width * TILE_PITCH_X - TILE_GAP;
+}
+
+float board_world_height(const Minesweeper* game)
+{
+	return 2 * OUTSIDE_PADDING + game->height * TILE_PITCH_Y - TILE_GAP;
+}
+
+float camera_scale(const camera& cam)
+{
+	return cam.zoom * cam.dpi_scale;
+}
+
+int world_to_screen(float world, float camera_pos, float scale)
+{
+	return (int)std::floor((world - camera_pos) * scale);
+}
+
+void camera_clamp(camera& cam, const Minesweeper* game)
+{
+	const float view_w = cam.viewport_w / camera_scale(cam);
+	const float view_h = cam.viewport_h / camera_scale(cam);
+	const float board_w = board_world_width(game);
+	const float board_h = board_world_height(game);
+
+	if(board_w <= view_w)
+		cam.x = (board_w - view_w) / 2.0f;
+	else
+		cam.x = std::clamp(cam.x, 0.0f, board_w - view_w);
+
+	if(board_h <= view_h)
+		cam.y = (board_h - view_h) / 2.0f;
+	else
+		cam.y = std::clamp(cam.y, 0.0f, board_h - view_h);
+}
+
+void camera_pan(camera& cam, const Minesweeper* game, float screen_dx, float screen_dy)
+{
+	cam.x += screen_dx / camera_scale(cam);
+	cam.y += screen_dy / camera_scale(cam);
+	camera_clamp(cam, game);
+}
+
+void camera_center_tile(camera& cam, const Minesweeper* game, int row, int col)
+{
+	cam.x = OUTSIDE_PADDING + (col - 1) * TILE_PITCH_X + TILE_WIDTH  / 2.0f - cam.viewport_w / camera_scale(cam) / 2.0f;
+	cam.y = OUTSIDE_PADDING + (row - 1) * TILE_PITCH_Y + TILE_HEIGHT / 2.0f - cam.viewport_h / camera_scale(cam) / 2.0f;
+	camera_clamp(cam, game);
+}
+
+float camera_fit_zoom(const camera& cam, const Minesweeper* game)
+{
+	// a minimized window has a 0x0 output, a zoom of 0 there would divide by zero wherever the scale is used
+	if(cam.viewport_w <= 0 || cam.viewport_h <= 0)
+		return MIN_ZOOM;
+
+	return std::min(cam.viewport_w / board_world_width(game),
+	                cam.viewport_h / board_world_height(game)) / cam.dpi_scale;
+}
+
+void camera_zoom_at(camera& cam, const Minesweeper* game, int screen_x, int screen_y, float factor)
+{
+	const float world_x = cam.x + screen_x / camera_scale(cam);
+	const float world_y = cam.y + screen_y / camera_scale(cam);
+
+	const float min_zoom = std::min(MIN_ZOOM, camera_fit_zoom(cam, game));
+	cam.zoom = std::clamp(cam.zoom * factor, min_zoom, MAX_ZOOM);
+	cam.x = world_x - screen_x / camera_scale(cam);
+	cam.y = world_y - screen_y / camera_scale(cam);
+	camera_clamp(cam, game);
+}
+
+tile_range camera_visible_tiles(const camera& cam, const Minesweeper* game)
+{
+	const float left   = cam.x - OUTSIDE_PADDING;
+	const float top    = cam.y - OUTSIDE_PADDING;
+	const float right  = left + cam.viewport_w / camera_scale(cam);
+	const float bottom = top  + cam.viewport_h / camera_scale(cam);
+
+	return {
+		.first_row = std::max(1, (int)std::floor(top / TILE_PITCH_Y) + 1),
+		.last_row  = std::min(game->height, (int)std::floor(bottom / TILE_PITCH_Y) + 1),
+		.first_col = std::max(1, (int)std::floor(left / TILE_PITCH_X) + 1),
+		.last_col  = std::min(game->width, (int)std::floor(right / TILE_PITCH_X) + 1),
+	};
+}
+
+bool pixel_to_tile(const camera& cam, const Minesweeper* game, int x, int y, int* row, int* column)
+{
+	const float board_x = cam.x + x / camera_scale(cam) - OUTSIDE_PADDING;
+	const float board_y = cam.y + y / camera_scale(cam) - OUTSIDE_PADDING;
+
+	if (board_x < 0 || board_y < 0)
+		return false;
+
+	const int tile_row = (int)(board_y / TILE_PITCH_Y) + 1;
+	const int tile_col = (int)(board_x / TILE_PITCH_X) + 1;
+
+	if (tile_row > game->height || tile_col > game->width)
+		return false;
+
+	*row    = tile_row;
+	*column = tile_col;
+
+	return true;
+}
+
+int window_to_output(const camera& cam, int window_pos)
+{
+	return (int)(window_pos * cam.dpi_scale);
+}
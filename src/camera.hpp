@@ -0,0 +1,72 @@
+#pragma once
+#include "minesweeper.hpp"
+
+// board geometry is in world units, the camera scales them to pixels at runtime
+constexpr int TILE_WIDTH  = 10;
+constexpr int TILE_HEIGHT = 10;
+
+constexpr int OUTSIDE_PADDING = 10;
+constexpr int INSIDE_TILE_PADDING = 1;
+
+// starting zoom for boards that fit the window, also multiplied by the display's dpi scale
+constexpr float DEFAULT_ZOOM = 3.0f;
+
+// tiles are separated by a 1px gap at the default zoom
+constexpr float TILE_GAP = 1.0f / DEFAULT_ZOOM;
+constexpr float TILE_PITCH_X = TILE_WIDTH  + TILE_GAP;
+constexpr float TILE_PITCH_Y = TILE_HEIGHT + TILE_GAP;
+
+// boards too big for the viewport can always be zoomed out until they fit
+constexpr float MIN_ZOOM  = 0.375f;
+constexpr float MAX_ZOOM  = 12.0f;
+constexpr float ZOOM_STEP = 1.1f;
+
+// maps world space to screen space, screen space is in renderer output pixels
+struct camera
+{
+	// world position of the top left corner of the viewport
+	float x = 0.0f, y = 0.0f;
+	float zoom = DEFAULT_ZOOM;
+
+	// output pixels per window pixel, above 1 on high-dpi displays
+	float dpi_scale = 1.0f;
+
+	// in output pixels, refreshed by the frontend every frame
+	int viewport_w = 0;
+	int viewport_h = 0;
+};
+
+// inclusive range of tiles, 1-based like the tilemap
+struct tile_range
+{
+	int first_row, last_row;
+	int first_col, last_col;
+};
+
+float board_world_width(const Minesweeper* game);
+float board_world_height(const Minesweeper* game);
+
+// screen pixels per world unit
+float camera_scale(const camera& cam);
+int world_to_screen(float world, float camera_pos, float scale);
+
+// keeps the board filling the viewport, boards smaller than the viewport are centered
+void camera_clamp(camera& cam, const Minesweeper* game);
+void camera_pan(camera& cam, const Minesweeper* game, float screen_dx, float screen_dy);
+
+// pans so the tile is in the middle of the viewport, as far as the board edges allow
+void camera_center_tile(camera& cam, const Minesweeper* game, int row, int col);
+
+// zoom at which the whole board fits the viewport, MIN_ZOOM while the viewport is empty
+float camera_fit_zoom(const camera& cam, const Minesweeper* game);
+
+// zooms while keeping the world point under (screen_x, screen_y) in place
+void camera_zoom_at(camera& cam, const Minesweeper* game, int screen_x, int screen_y, float factor);
+
+tile_range camera_visible_tiles(const camera& cam, const Minesweeper* game);
+
+// inverse of the camera transform, returns false for pixels outside the board
+bool pixel_to_tile(const camera& cam, const Minesweeper* game, int x, int y, int* row, int* column);
+
+// mouse events are in window coordinates, the camera works in output pixels
+int window_to_output(const camera& cam, int window_pos);
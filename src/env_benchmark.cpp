@@ -0,0 +1,76 @@
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+#include "env_benchmark.hpp"
+#include "batch_env.hpp"
+#include "mine_oracle.hpp"
+
+// long enough that thread start up doesn't show in the numbers
+constexpr int BENCHMARK_STEPS = 2000;
+
+struct env_slice_result
+{
+	uint64_t games = 0;
+	uint64_t wins = 0;
+};
+
+// a bot that opens random tiles and flags one in eight, about as cheap as an action can be picked
+static void run_slice(batch_env* env, int first, int last, env_slice_result* result)
+{
+	std::vector<int32_t> actions(env->count, 0);
+	uint64_t state = oracle_mix((uint64_t)first + 1);
+	const uint64_t tiles = env->tiles;
+
+	for(int step = 0; step < BENCHMARK_STEPS; step++) {
+		for(int board = first; board < last; board++) {
+			state += 0x9e3779b97f4a7c15ull;
+			const uint64_t random = oracle_mix(state);
+			actions[board] = (int32_t)(((random >> 32) * tiles) >> 32) + ((random & 7) == 0 ? (int32_t)tiles : 0);
+		}
+
+		batch_env_step_range(env, actions.data(), first, last);
+
+		for(int board = first; board < last; board++) {
+			result->games += env->dones[board];
+			result->wins += env->dones[board] && env->rewards[board] > 0;
+		}
+	}
+}
+
+int run_env_benchmark(int width, int height, int bombcount, int boards, int threads)
+{
+	batch_env env;
+	batch_env_init(&env, boards, width, height, bombcount, 1);
+
+	threads = std::clamp(threads, 1, boards);
+	std::vector<env_slice_result> results(threads);
+	std::vector<std::thread> pool;
+
+	const auto start = std::chrono::steady_clock::now();
+	for(int i = 0; i < threads; i++) {
+		const int first = (int)((int64_t)boards * i / threads);
+		const int last = (int)((int64_t)boards * (i + 1) / threads);
+		pool.emplace_back(run_slice, &env, first, last, &results[i]);
+	}
+
+	for(std::thread& thread : pool)
+		thread.join();
+	const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	env_slice_result total;
+	for(const env_slice_result& result : results) {
+		total.games += result.games;
+		total.wins += result.wins;
+	}
+
+	const double steps = (double)boards * BENCHMARK_STEPS;
+	printf("%d boards of %dx%d with %d bombs, %d steps each on %d threads\n", boards, width, height, env.bombcount, BENCHMARK_STEPS, threads);
+	printf("%.1f M steps/s, %.1f ns per step per thread, %llu games finished, %llu won\n",
+		steps / seconds / 1e6, seconds * threads / steps * 1e9, (unsigned long long)total.games, (unsigned long long)total.wins);
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,5 @@
+#pragma once
+
+// steps boards of the given size with random actions, split across threads, and prints steps per second
+// returns the process exit code, build with release=1 for meaningful numbers
+int run_env_benchmark(int width, int height, int bombcount, int boards, int threads);
@@ -0,0 +1,85 @@
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+
+#include "glyph_cache.hpp"
+#include "renderer.hpp"
+#include "globals.hpp"
+
+constexpr int GLYPH_CACHE_CAPACITY = 8;
+
+// tile sizes are rounded up to steps of 2^(1/8) so zooming only expands a handful of sizes
+constexpr float GLYPH_SIZE_STEPS_PER_OCTAVE = 8.0f;
+constexpr int GLYPH_MIN_TILE_SIZE = 4;
+
+// the original 28pt numbers were made for 30px tiles
+constexpr float GLYPH_POINTS_PER_TILE_PIXEL = 28.0f / 30.0f;
+
+constexpr SDL_Color NUMBER_COLORS[] = {
+	{0,0,255,255}, {0,128,0,255}, {255,0,0,255},
+	{0,0,128,255}, {128,0,0,255}, {0,128,128,255},
+	{0,0,0,255},   {128,128,128,255}
+};
+
+static int quantize_tile_size(int tile_pixels)
+{
+	tile_pixels = std::max(tile_pixels, GLYPH_MIN_TILE_SIZE);
+	const float step = std::ceil(std::log2((float)tile_pixels) * GLYPH_SIZE_STEPS_PER_OCTAVE);
+	return (int)std::ceil(std::exp2(step / GLYPH_SIZE_STEPS_PER_OCTAVE) - 0.001f);
+}
+
+static void destroy_set(RenderBackend* backend, glyph_set* set)
+{
+	for(render_texture& number : set->numbers)
+		backend->destroy_texture(number);
+}
+
+void glyph_cache_init(glyph_cache* cache, TTF_Font* font)
+{
+	sdf_atlas_build(&cache->atlas, font);
+	cache->sets.clear();
+	cache->sets.reserve(GLYPH_CACHE_CAPACITY);
+	cache->use_counter = 0;
+}
+
+void glyph_cache_destroy(RenderBackend* backend, glyph_cache* cache)
+{
+	for(glyph_set& set : cache->sets)
+		destroy_set(backend, &set);
+
+	cache->sets.clear();
+}
+
+const glyph_set* glyph_cache_get(RenderBackend* backend, glyph_cache* cache, int tile_pixels)
+{
+	const int tile_size = quantize_tile_size(tile_pixels);
+	cache->use_counter++;
+
+	for(glyph_set& set : cache->sets) {
+		if(set.tile_size == tile_size) {
+			set.last_used = cache->use_counter;
+			return &set;
+		}
+	}
+
+	if((int)cache->sets.size() >= GLYPH_CACHE_CAPACITY) {
+		auto lru = std::min_element(cache->sets.begin(), cache->sets.end(), 
+			[](const glyph_set& a, const glyph_set& b) { return a.last_used < b.last_used; });
+		destroy_set(backend, &*lru);
+		cache->sets.erase(lru);
+	}
+
+	const int point_size = std::max(1, (int)std::lround(tile_size * GLYPH_POINTS_PER_TILE_PIXEL));
+
+	glyph_set set = {};
+	set.tile_size = tile_size;
+	set.last_used = cache->use_counter;
+
+	for (int i = 0; i <= 7; i++) {
+		SDL_Surface* surface = sdf_expand(&cache->atlas, i, point_size, NUMBER_COLORS[i]);
+		set.numbers[i] = backend->create_texture(surface);
+	}
+
+	cache->sets.push_back(set);
+	return &cache->sets.back();
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+
+#include <vector>
+
+#include "sdf.hpp"
+#include "renderer.hpp"
+
+// numbers 1-8 rasterized for one tile size
+struct glyph_set
+{
+	int tile_size;
+	render_texture numbers[8];
+	uint64_t last_used;
+};
+
+// expands number glyphs from the sdf atlas once per (quantized) tile size, least recently used sets are evicted
+struct glyph_cache
+{
+	sdf_atlas atlas;
+	std::vector<glyph_set> sets;
+	uint64_t use_counter = 0;
+};
+
+// builds the sdf atlas, the font isn't used after this
+void glyph_cache_init(glyph_cache* cache, TTF_Font* font);
+void glyph_cache_destroy(RenderBackend* backend, glyph_cache* cache);
+
+// glyphs made for a tile size of at least tile_pixels, scale them by tile_pixels / tile_size when drawing
+// the returned set stays valid until the next call
+const glyph_set* glyph_cache_get(RenderBackend* backend, glyph_cache* cache, int tile_pixels);
@@ -0,0 +1,114 @@
+#include <cstdint>
+#include <vector>
+
+#include "hint.hpp"
+
+// calls visit(row, col) for the neighbors of (row, col) that are on the board
+template <typename Visit>
+static void for_each_neighbor(const board_snapshot& board, int row, int col, Visit visit)
+{
+	for(int i = -1; i <= 1; i++) {
+		for(int j = -1; j <= 1; j++) {
+			if(i == 0 && j == 0)
+				continue;
+			if(row + i < 1 || col + j < 1 || row + i > board.height() || col + j > board.width())
+				continue;
+
+			visit(row + i, col + j);
+		}
+	}
+}
+
+bool hint_find_safe_tile(const board_snapshot& board, int near_row, int near_col, int* row, int* col)
+{
+	if(board.dead())
+		return false;
+
+	const int width = board.width(), height = board.height();
+	std::vector<uint64_t> mines(((size_t)width * height + 63) / 64, 0);
+	auto is_mine = [&](int r, int c) {
+		const size_t bit = (size_t)(r - 1) * width + (c - 1);
+		return (mines[bit / 64] >> (bit % 64)) & 1;
+	};
+
+	// a number with exactly as many closed neighbors has a mine under each of them
+	for(int r = 1; r <= height; r++) {
+		for(int c = 1; c <= width; c++) {
+			const Tile& tile = board.tile(r, c);
+			if(!tile.open || tile.data == TILE_EMPTY)
+				continue;
+
+			int closed = 0;
+			for_each_neighbor(board, r, c, [&](int nr, int nc) { closed += !board.tile(nr, nc).open; });
+			if(closed != tile.data)
+				continue;
+
+			for_each_neighbor(board, r, c, [&](int nr, int nc) {
+				if(!board.tile(nr, nc).open) {
+					const size_t bit = (size_t)(nr - 1) * width + (nc - 1);
+					mines[bit / 64] |= 1ull << (bit % 64);
+				}
+			});
+		}
+	}
+
+	// a number whose mines are all known makes the rest of its closed neighbors safe
+	int64_t best_distance = INT64_MAX;
+	for(int r = 1; r <= height; r++) {
+		for(int c = 1; c <= width; c++) {
+			const Tile& tile = board.tile(r, c);
+			if(!tile.open || tile.data == TILE_EMPTY)
+				continue;
+
+			int known = 0;
+			for_each_neighbor(board, r, c, [&](int nr, int nc) { known += is_mine(nr, nc); });
+			if(known != tile.data)
+				continue;
+
+			for_each_neighbor(board, r, c, [&](int nr, int nc) {
+				const Tile& neighbor = board.tile(nr, nc);
+				if(neighbor.open || neighbor.flagged || is_mine(nr, nc))
+					return;
+
+				const int64_t distance = (int64_t)(nr - near_row) * (nr - near_row) + (int64_t)(nc - near_col) * (nc - near_col);
+				if(distance < best_distance) {
+					best_distance = distance;
+					*row = nr;
+					*col = nc;
+				}
+			});
+		}
+	}
+
+	return best_distance != INT64_MAX;
+}
+
+void hint_start(hint_worker* worker, board_snapshot board, int near_row, int near_col)
+{
+	hint_stop(worker);
+
+	worker->done = false;
+	worker->running = true;
+	worker->thread = std::thread([worker, board = std::move(board), near_row, near_col]() {
+		worker->found = hint_find_safe_tile(board, near_row, near_col, &worker->row, &worker->col);
+		worker->done.store(true, std::memory_order_release);
+	});
+}
+
+bool hint_poll(hint_worker* worker)
+{
+	if(!worker->running || !worker->done.load(std::memory_order_acquire))
+		return false;
+
+	worker->thread.join();
+	worker->running = false;
+	return true;
+}
+
+void hint_stop(hint_worker* worker)
+{
+	if(worker->thread.joinable())
+		worker->thread.join();
+
+	worker->running = false;
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <atomic>
+#include <thread>
+
+#include "board_snapshot.hpp"
+
+// looks for a closed tile that the open numbers prove safe, the one nearest (near_row, near_col) wins
+// only reads what the player can see, flags are ignored since they can be wrong
+bool hint_find_safe_tile(const board_snapshot& board, int near_row, int near_col, int* row, int* col);
+
+// runs hint_find_safe_tile on its own thread, the game keeps going while it searches a snapshot
+struct hint_worker
+{
+	std::thread thread;
+	std::atomic<bool> done = false;
+	bool running = false;
+
+	bool found = false;
+	int row = 0, col = 0;
+};
+
+void hint_start(hint_worker* worker, board_snapshot board, int near_row, int near_col);
+
+// true once the search is over, found, row and col then hold the result
+bool hint_poll(hint_worker* worker);
+
+// waits for a search still running
+void hint_stop(hint_worker* worker);
@@ -0,0 +1,278 @@
+#include <algorithm>
+#include <iostream>
+
+#include "infinite_board.hpp"
+
+// 64 bit offsets, plain fseek takes a long which is 32 bits on Windows
+static bool seek_slot(FILE* file, int64_t slot)
+{
+	const int64_t offset = slot * (int64_t)sizeof(packed_chunk);
+#ifdef _WIN32
+	return _fseeki64(file, offset, SEEK_SET) == 0;
+#else
+	return fseeko(file, offset, SEEK_SET) == 0;
+#endif
+}
+
+InfiniteMinesweeper::InfiniteMinesweeper(uint64_t seed, double density, size_t memory_budget)
+	: oracle(make_mine_oracle(seed, std::clamp(density, INFINITE_MIN_DENSITY, INFINITE_MAX_DENSITY))),
+	  max_resident(std::max(INFINITE_MIN_RESIDENT_CHUNKS, memory_budget / sizeof(board_chunk)))
+{
+}
+
+InfiniteMinesweeper::~InfiniteMinesweeper()
+{
+	// tmpfile deletes itself when closed
+	if(this->spill_file)
+		fclose(this->spill_file);
+}
+
+board_chunk& InfiniteMinesweeper::chunk_at(chunk_coord coord)
+{
+	auto [it, inserted] = this->chunks.try_emplace(coord);
+	board_chunk& chunk = it->second;
+	chunk.last_used = ++this->use_counter;
+	if(!inserted)
+		return chunk;
+
+	if(page_in(coord, &chunk))
+		return chunk;
+
+	for(int i = 0; i < CHUNK_TILES; i++) {
+		const int64_t row = (coord.row << CHUNK_SHIFT) + i / CHUNK_SIZE;
+		const int64_t col = (coord.col << CHUNK_SHIFT) + i % CHUNK_SIZE;
+
+		if(is_mine(row, col))
+			chunk.tiles[i].data = TILE_BOMB;
+	}
+
+	return chunk;
+}
+
+// rebuilds the chunk from its packed planes, mines and numbers come from the oracle again
+bool InfiniteMinesweeper::page_in(chunk_coord coord, board_chunk* chunk)
+{
+	auto it = this->spilled.find(coord);
+	if(it == this->spilled.end())
+		return false;
+
+	packed_chunk packed = {};
+	if(!seek_slot(this->spill_file, it->second) || fread(&packed, sizeof(packed), 1, this->spill_file) != 1)
+		std::cout << "Couldn't read chunk " << coord.row << "," << coord.col << " back from the spill file, it is reset\n";
+
+	this->free_slots.push_back(it->second);
+	this->spilled.erase(it);
+
+	for(int i = 0; i < CHUNK_TILES; i++) {
+		const int64_t row = (coord.row << CHUNK_SHIFT) + i / CHUNK_SIZE;
+		const int64_t col = (coord.col << CHUNK_SHIFT) + i % CHUNK_SIZE;
+		Tile& tile = chunk->tiles[i];
+
+		tile.open    = (packed.open[i / 64]    >> (i % 64)) & 1;
+		tile.flagged = (packed.flagged[i / 64] >> (i % 64)) & 1;
+
+		if(is_mine(row, col))
+			tile.data = TILE_BOMB;
+		else if(tile.open)
+			tile.data = count_neighbors(row, col);
+	}
+
+	return true;
+}
+
+void InfiniteMinesweeper::evict(chunk_coord coord, const board_chunk& chunk)
+{
+	packed_chunk packed = {};
+	bool touched = false;
+	for(int i = 0; i < CHUNK_TILES; i++) {
+		packed.open[i / 64]    |= (uint64_t)chunk.tiles[i].open    << (i % 64);
+		packed.flagged[i / 64] |= (uint64_t)chunk.tiles[i].flagged << (i % 64);
+		touched |= chunk.tiles[i].open || chunk.tiles[i].flagged;
+	}
+
+	// the oracle regenerates an untouched chunk exactly
+	if(!touched)
+		return;
+
+	int64_t slot = this->slot_count;
+	if(!this->free_slots.empty()) {
+		slot = this->free_slots.back();
+		this->free_slots.pop_back();
+	}
+	else {
+		this->slot_count++;
+	}
+
+	if(!seek_slot(this->spill_file, slot) || fwrite(&packed, sizeof(packed), 1, this->spill_file) != 1)
+		std::cout << "Couldn't write chunk " << coord.row << "," << coord.col << " to the spill file\n";
+
+	this->spilled[coord] = slot;
+}
+
+void InfiniteMinesweeper::trim_resident()
+{
+	if(this->chunks.size() <= this->max_resident)
+		return;
+
+	if(!this->spill_file) {
+		this->spill_file = tmpfile();
+		if(!this->spill_file) {
+			std::cout << "Couldn't create a spill file, staying over the memory budget\n";
+			this->max_resident = SIZE_MAX;
+			return;
+		}
+	}
+
+	// evicting down to 3/4 of the budget so the sort isn't repeated for every new chunk
+	std::vector<std::pair<uint64_t, chunk_coord>> by_age;
+	by_age.reserve(this->chunks.size());
+	for(const auto& [coord, chunk] : this->chunks)
+		by_age.push_back({chunk.last_used, coord});
+
+	const size_t evict_count = this->chunks.size() - this->max_resident * 3 / 4;
+	std::nth_element(by_age.begin(), by_age.begin() + evict_count, by_age.end(),
+		[](const auto& a, const auto& b) { return a.first < b.first; });
+
+	for(size_t i = 0; i < evict_count; i++) {
+		auto it = this->chunks.find(by_age[i].second);
+		evict(it->first, it->second);
+		this->chunks.erase(it);
+	}
+
+	fflush(this->spill_file);
+}
+
+Tile& InfiniteMinesweeper::tile_at(int64_t row, int64_t col)
+{
+	return chunk_at(chunk_of(row, col)).tiles[chunk_index(row, col)];
+}
+
+bool InfiniteMinesweeper::is_mine(int64_t row, int64_t col) const
+{
+	const bool safe_start = std::abs(row) <= 1 && std::abs(col) <= 1;
+	return !safe_start && oracle_is_mine(this->oracle, row, col);
+}
+
+// asks the oracle directly, tiles on chunk borders don't generate the neighboring chunks
+TileData InfiniteMinesweeper::count_neighbors(int64_t row, int64_t col) const
+{
+	// only the tiles next to the safe start need the slow path
+	if(std::abs(row) > 2 || std::abs(col) > 2)
+		return oracle_count(this->oracle, row, col);
+
+	int count = 0;
+	for (int i = -1; i <= 1; i++)
+		for (int j = -1; j <= 1; j++)
+			if ((i != 0 || j != 0) && is_mine(row + i, col + j))
+				count++;
+
+	return (TileData)count;
+}
+
+Tile InfiniteMinesweeper::peek_tile(int64_t row, int64_t col)
+{
+	const board_chunk* chunk = find_chunk(chunk_of(row, col));
+	if(chunk)
+		return chunk->tiles[chunk_index(row, col)];
+
+	return { .data = is_mine(row, col) ? TILE_BOMB : TILE_EMPTY };
+}
+
+const board_chunk* InfiniteMinesweeper::find_chunk(chunk_coord coord)
+{
+	auto it = this->chunks.find(coord);
+	if(it != this->chunks.end()) {
+		it->second.last_used = ++this->use_counter;
+		return &it->second;
+	}
+
+	if(!this->spilled.contains(coord))
+		return nullptr;
+
+	// nobody holds tile references between finds, so this is a safe point to make room
+	trim_resident();
+	return &chunk_at(coord);
+}
+
+void InfiniteMinesweeper::open_tile(int64_t row, int64_t col)
+{
+	queue_open(row, col);
+	reveal_step(std::chrono::steady_clock::time_point::max());
+}
+
+void InfiniteMinesweeper::queue_open(int64_t row, int64_t col)
+{
+	if (this->dead) return;
+
+	this->pending_reveal.push_back({row, col});
+}
+
+bool InfiniteMinesweeper::reveal_step(std::chrono::steady_clock::time_point deadline)
+{
+	// reading the clock for every tile would cost more than opening it
+	constexpr int DEADLINE_CHECK_INTERVAL = 4096;
+
+	std::vector<std::pair<int64_t, int64_t>>& pending = this->pending_reveal;
+
+	int opened = 0;
+	while(!pending.empty()) {
+		if(this->dead) {
+			pending.clear();
+			break;
+		}
+
+		if(++opened % DEADLINE_CHECK_INTERVAL == 0) {
+			trim_resident();
+			if(std::chrono::steady_clock::now() >= deadline)
+				break;
+		}
+
+		auto [tile_row, tile_col] = pending.back();
+		pending.pop_back();
+
+		Tile* tile = &tile_at(tile_row, tile_col);
+		if(tile->flagged || tile->open)
+			continue;
+
+		if(tile->data == TILE_BOMB) {
+			tile->open = true;
+			this->dead = true;
+			this->changed_tiles.push_back({tile_row, tile_col});
+			continue;
+		}
+
+		tile->data = count_neighbors(tile_row, tile_col);
+		tile->open = true;
+		this->changed_tiles.push_back({tile_row, tile_col});
+
+		// open neighboring empty tiles
+		if (tile->data == TILE_EMPTY) {
+			for (int i = -1; i <= 1; i++) {
+				for (int j = -1; j <= 1; j++) {
+					if (i == 0 && j == 0) continue;
+
+					const Tile& neighbor = tile_at(tile_row + i, tile_col + j);
+					if(!neighbor.open && !neighbor.flagged)
+						pending.push_back({tile_row + i, tile_col + j});
+				}
+			}
+		}
+	}
+
+	trim_resident();
+	return !pending.empty();
+}
+
+void InfiniteMinesweeper::flag_tile(int64_t row, int64_t col)
+{
+	if (this->dead) return;
+
+	// flagging doesn't need the mines, but the flag has to live in a chunk
+	Tile* tile = &tile_at(row, col);
+	if(!tile->open) {
+		tile->flagged = !tile->flagged;
+		this->changed_tiles.push_back({row, col});
+	}
+
+	trim_resident();
+}
@@ -0,0 +1,118 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "minesweeper.hpp"
+#include "mine_oracle.hpp"
+
+// tiles per chunk side, a power of two so tile to chunk coordinates is a shift
+constexpr int CHUNK_SHIFT = 5;
+constexpr int CHUNK_SIZE = 1 << CHUNK_SHIFT;
+constexpr int CHUNK_TILES = CHUNK_SIZE * CHUNK_SIZE;
+
+// below roughly 0.1 the empty areas stop being finite and a single click could open forever
+constexpr double INFINITE_MIN_DENSITY = 0.12;
+constexpr double INFINITE_MAX_DENSITY = 0.9;
+
+struct chunk_coord
+{
+	int64_t row, col;
+
+	bool operator==(const chunk_coord&) const = default;
+};
+
+struct chunk_coord_hash
+{
+	size_t operator()(const chunk_coord& coord) const
+	{
+		return std::hash<uint64_t>()((uint64_t)coord.row * 0x9e3779b97f4a7c15ull ^ (uint64_t)coord.col);
+	}
+};
+
+// below roughly this many chunks a terminal screen wouldn't fit in memory anymore
+constexpr size_t INFINITE_MIN_RESIDENT_CHUNKS = 64;
+
+// mines are copied from the oracle when the chunk is created, numbers are only filled in when a tile is opened
+struct board_chunk
+{
+	Tile tiles[CHUNK_TILES];
+	uint64_t last_used = 0;
+};
+
+// what's written to the spill file, mines and numbers can be recomputed from the oracle
+struct packed_chunk
+{
+	uint64_t open[CHUNK_TILES / 64];
+	uint64_t flagged[CHUNK_TILES / 64];
+};
+
+inline chunk_coord chunk_of(int64_t row, int64_t col)
+{
+	// arithmetic shift rounds towards negative infinity, so negative rows land in the right chunk
+	return { row >> CHUNK_SHIFT, col >> CHUNK_SHIFT };
+}
+
+inline int chunk_index(int64_t row, int64_t col)
+{
+	return (int)(row & (CHUNK_SIZE - 1)) * CHUNK_SIZE + (int)(col & (CHUNK_SIZE - 1));
+}
+
+// unbounded board made of chunks generated on first access, memory grows with the explored area only
+// tiles around (0, 0) are never mines so the game can start there
+// past the memory budget the least recently used chunks are packed into a temporary file and paged back in on access
+class InfiniteMinesweeper {
+	mine_oracle oracle;
+
+	std::unordered_map<chunk_coord, board_chunk, chunk_coord_hash> chunks;
+	size_t max_resident;
+	uint64_t use_counter = 0;
+
+	// slot in spill_file of every evicted chunk that had something open or flagged, untouched chunks are just dropped
+	std::unordered_map<chunk_coord, int64_t, chunk_coord_hash> spilled;
+	std::vector<int64_t> free_slots;
+	int64_t slot_count = 0;
+	FILE* spill_file = nullptr;
+
+	std::vector<std::pair<int64_t, int64_t>> pending_reveal;
+
+	board_chunk& chunk_at(chunk_coord coord);
+	bool page_in(chunk_coord coord, board_chunk* chunk);
+	void evict(chunk_coord coord, const board_chunk& chunk);
+
+	// only called where no Tile references are held, evicting moves chunks out of memory
+	void trim_resident();
+
+	Tile& tile_at(int64_t row, int64_t col);
+	bool is_mine(int64_t row, int64_t col) const;
+	TileData count_neighbors(int64_t row, int64_t col) const;
+public:
+	bool dead = false;
+
+	// (row, col) of every tile opened or (un)flagged, renderers consume and clear this each frame
+	std::vector<std::pair<int64_t, int64_t>> changed_tiles;
+
+	InfiniteMinesweeper(uint64_t seed, double density, size_t memory_budget);
+	~InfiniteMinesweeper();
+
+	InfiniteMinesweeper(const InfiniteMinesweeper&) = delete;
+	InfiniteMinesweeper& operator=(const InfiniteMinesweeper&) = delete;
+
+	// never generates anything, tiles of chunks that don't exist yet are closed with their mine from the oracle
+	// spilled chunks are paged back in, so the pointer is only valid until the next call
+	Tile peek_tile(int64_t row, int64_t col);
+	const board_chunk* find_chunk(chunk_coord coord);
+
+	size_t resident_chunks() const { return chunks.size(); }
+	size_t spilled_chunks() const { return spilled.size(); }
+
+	// same contract as Minesweeper
+	void open_tile(int64_t row, int64_t col);
+	void queue_open(int64_t row, int64_t col);
+	bool reveal_step(std::chrono::steady_clock::time_point deadline);
+	bool revealing() const { return !pending_reveal.empty(); }
+	void flag_tile(int64_t row, int64_t col);
+};
@@ -0,0 +1,213 @@
+#include <iostream>
+#include <chrono>
+#include <cstring>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#include "journal.hpp"
+#include "save.hpp"
+
+Minesweeper* journal_recover(const char* path, uint64_t* generation)
+{
+	FILE* probe = fopen(path, "rb");
+	if(!probe)
+		return nullptr;
+	fclose(probe);
+
+	save_view view;
+	if(!save_open(&view, path))
+		return nullptr;
+
+	Minesweeper* game = save_load_game(view);
+	*generation = view.header->generation;
+	save_close(&view);
+
+	const std::string journal_path = std::string(path) + ".journal";
+	FILE* file = fopen(journal_path.c_str(), "rb");
+	if(!file)
+		return game;
+
+	// a journal left over from an older snapshot is already part of this one
+	journal_header header = {};
+	const bool matches = fread(&header, sizeof(header), 1, file) == 1 &&
+		std::memcmp(header.magic, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC)) == 0 &&
+		header.version == JOURNAL_VERSION && header.generation == *generation;
+
+	// a record cut short by the crash is simply not read
+	journal_record record;
+	while(matches && fread(&record, sizeof(record), 1, file) == 1) {
+		const journal_action action = (journal_action)(record.action_row >> JOURNAL_ROW_BITS);
+		const int row = (int)(record.action_row & ((1u << JOURNAL_ROW_BITS) - 1));
+		const int col = (int)record.col;
+
+		if(row < 1 || col < 1 || row > game->height || col > game->width)
+			continue;
+
+		if(action == JOURNAL_OPEN)
+			game->open_tile(row, col);
+		else if(action == JOURNAL_FLAG)
+			game->flag_tile(row, col);
+	}
+
+	fclose(file);
+
+	// renderers start from the whole board anyway
+	game->changed_tiles.clear();
+	return game;
+}
+
+static void flush_records(journal* log)
+{
+	// with no journal to append to only the next snapshot can keep these moves,
+	// writing them later would replay them on top of a snapshot that already has them
+	if(!log->file) {
+		log->write_buffer.clear();
+		return;
+	}
+
+	if(log->write_buffer.empty())
+		return;
+
+	bool written = fwrite(log->write_buffer.data(), sizeof(journal_record), log->write_buffer.size(), log->file) == log->write_buffer.size() &&
+		fflush(log->file) == 0;
+
+	// survives power loss too, not only a crash of the game
+#ifndef _WIN32
+	written = written && fdatasync(fileno(log->file)) == 0;
+#endif
+
+	log->write_buffer.clear();
+	if(written)
+		return;
+
+	// a record cut in half would shift every one after it, so nothing more goes into this journal
+	std::cout << "Couldn't write to " << log->journal_path << ", moves are recorded again after the next snapshot\n";
+	fclose(log->file);
+	log->file = nullptr;
+}
+
+// the snapshot is in place before the old journal is dropped, a crash in between loses nothing
+static void write_snapshot(journal* log, std::vector<uint64_t>* snapshot)
+{
+	flush_records(log);
+
+	const uint64_t generation = ((const save_header*)snapshot->data())->generation;
+	const bool written = save_write(*snapshot, log->snapshot_path.c_str());
+	delete snapshot;
+
+	if(!written)
+		return;
+
+	if(log->file)
+		fclose(log->file);
+
+	log->file = fopen(log->journal_path.c_str(), "wb");
+	if(!log->file) {
+		std::cout << "Couldn't create " << log->journal_path << ", moves are no longer recorded\n";
+		return;
+	}
+
+	journal_header header = {};
+	std::memcpy(header.magic, JOURNAL_MAGIC, sizeof(header.magic));
+	header.version = JOURNAL_VERSION;
+	header.generation = generation;
+	fwrite(&header, sizeof(header), 1, log->file);
+	fflush(log->file);
+}
+
+static void journal_writer(journal* log)
+{
+	bool running = true;
+	while(running) {
+		// read before draining so nothing queued before journal_stop is missed
+		running = log->running;
+
+		journal_entry entry;
+		while(log->queue.pop(&entry)) {
+			if(entry.snapshot)
+				write_snapshot(log, entry.snapshot);
+			else
+				log->write_buffer.push_back(entry.record);
+		}
+
+		flush_records(log);
+
+		if(running)
+			std::this_thread::sleep_for(std::chrono::milliseconds(JOURNAL_FLUSH_MS));
+	}
+
+	if(log->file)
+		fclose(log->file);
+	log->file = nullptr;
+}
+
+static void drain_overflow(journal* log)
+{
+	while(!log->overflow.empty() && log->queue.push(log->overflow.front()))
+		log->overflow.pop_front();
+}
+
+static void push_entry(journal* log, const journal_entry& entry)
+{
+	// keeps the order, nothing may overtake what is already waiting
+	drain_overflow(log);
+
+	if(!log->overflow.empty() || !log->queue.push(entry))
+		log->overflow.push_back(entry);
+}
+
+bool journal_start(journal* log, const char* path, const Minesweeper* game, uint64_t generation)
+{
+	if(game->height > JOURNAL_MAX_HEIGHT) {
+		std::cout << "Boards over " << JOURNAL_MAX_HEIGHT << " rows can't be journaled\n";
+		return false;
+	}
+
+	log->snapshot_path = path;
+	log->journal_path = std::string(path) + ".journal";
+	log->generation = generation;
+
+	log->running = true;
+	log->writer = std::thread(journal_writer, log);
+
+	journal_snapshot(log, game);
+	return true;
+}
+
+void journal_log(journal* log, journal_action action, int row, int col)
+{
+	push_entry(log, { .record = { .action_row = ((uint32_t)action << JOURNAL_ROW_BITS) | (uint32_t)row, .col = (uint32_t)col }, .snapshot = nullptr });
+	log->records_since_snapshot++;
+}
+
+void journal_snapshot(journal* log, const Minesweeper* game)
+{
+	// packing is the only part done on the game thread, writing it out is left to the writer
+	std::vector<uint64_t>* snapshot = new std::vector<uint64_t>();
+	save_pack(game, ++log->generation, snapshot);
+
+	push_entry(log, { .record = {}, .snapshot = snapshot });
+	log->records_since_snapshot = 0;
+}
+
+void journal_update(journal* log, const Minesweeper* game)
+{
+	drain_overflow(log);
+
+	if(log->records_since_snapshot >= JOURNAL_SNAPSHOT_RECORDS && !game->revealing())
+		journal_snapshot(log, game);
+}
+
+void journal_stop(journal* log)
+{
+	// the writer is gone after this, whatever overflowed is handed over while it still drains
+	while(!log->overflow.empty()) {
+		drain_overflow(log);
+		std::this_thread::yield();
+	}
+
+	log->running = false;
+	log->writer.join();
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "minesweeper.hpp"
+#include "spsc_ring.hpp"
+
+constexpr char JOURNAL_MAGIC[4] = { 'M', 'S', 'W', 'J' };
+constexpr uint32_t JOURNAL_VERSION = 1;
+
+// how often the writer thread wakes up to write what was queued
+constexpr int JOURNAL_FLUSH_MS = 50;
+
+// a new snapshot after this many moves keeps recovery replays short
+constexpr uint64_t JOURNAL_SNAPSHOT_RECORDS = 8192;
+
+constexpr size_t JOURNAL_QUEUE_CAPACITY = 1 << 14;
+
+enum journal_action : uint32_t
+{
+	JOURNAL_OPEN = 0,
+	JOURNAL_FLAG = 1,
+};
+
+// the action lives in the top bits of the row, taller boards can't be journaled or recorded
+constexpr int JOURNAL_ROW_BITS = 30;
+constexpr int JOURNAL_MAX_HEIGHT = (1 << JOURNAL_ROW_BITS) - 1;
+
+struct journal_header
+{
+	char magic[4];
+	uint32_t version;
+	uint64_t generation; // the records apply on top of the snapshot with this generation
+};
+
+struct journal_record
+{
+	uint32_t action_row;
+	uint32_t col;
+};
+
+// either a move or a packed snapshot that replaces the journal
+struct journal_entry
+{
+	journal_record record;
+	std::vector<uint64_t>* snapshot;
+};
+
+// the snapshot is a regular save at path, moves since then are appended to path.journal
+// the game thread only queues entries, a background thread does all of the disk io
+struct journal
+{
+	std::string snapshot_path;
+	std::string journal_path;
+
+	std::thread writer;
+	std::atomic<bool> running = false;
+	SpscRing<journal_entry, JOURNAL_QUEUE_CAPACITY> queue;
+
+	// game thread only, holds entries while the queue is full so the game never waits on the writer
+	std::deque<journal_entry> overflow;
+	uint64_t generation = 0;
+	uint64_t records_since_snapshot = 0;
+
+	// writer thread only
+	FILE* file = nullptr;
+	std::vector<journal_record> write_buffer;
+};
+
+// loads the snapshot at path and replays its journal, nullptr if there is no snapshot
+// generation is set to the snapshot's so the next one can continue counting
+Minesweeper* journal_recover(const char* path, uint64_t* generation);
+
+// starts the writer thread with a snapshot of game, every move after this is recorded
+// returns false if the board is too tall for the move encoding
+bool journal_start(journal* log, const char* path, const Minesweeper* game, uint64_t generation);
+void journal_log(journal* log, journal_action action, int row, int col);
+
+// call after replacing the board, or anytime to shorten the journal
+void journal_snapshot(journal* log, const Minesweeper* game);
+
+// takes a snapshot once enough moves piled up and the board isn't halfway through a reveal
+void journal_update(journal* log, const Minesweeper* game);
+
+// writes everything still queued and joins the writer thread
+void journal_stop(journal* log);
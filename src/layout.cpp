@@ -0,0 +1,70 @@
+#include <cmath>
+#include <algorithm>
+
+#include "layout.hpp"
+
+// spans of the tiles first..last along one axis
+static void build_axis(std::vector<tile_span>& bounds, std::vector<tile_span>& insides, std::vector<tile_span> (&numbers)[8],
+                       int first, int last, float pitch, int tile_size, float camera_pos, float scale,
+                       const glyph_set* glyphs, float glyph_scale, bool horizontal)
+{
+	const int count = std::max(0, last - first + 1);
+	const int inside_padding = (int)(INSIDE_TILE_PADDING * scale);
+
+	bounds.resize(count);
+	insides.resize(count);
+	for(std::vector<tile_span>& number : numbers)
+		number.resize(count);
+
+	for(int i = 0; i < count; i++) {
+		const float tile_world = OUTSIDE_PADDING + (first + i - 1) * pitch;
+		const int pos  = world_to_screen(tile_world, camera_pos, scale);
+		const int size = std::max(1, world_to_screen(tile_world + tile_size, camera_pos, scale) - pos);
+
+		bounds[i]  = { .pos = pos, .size = size };
+		insides[i] = { .pos = pos + inside_padding, .size = size - inside_padding * 2 };
+
+		for(int number = 0; number < 8; number++) {
+			const render_texture& texture = glyphs->numbers[number];
+			const int number_size = (int)((horizontal ? texture.w : texture.h) * glyph_scale);
+			numbers[number][i] = { .pos = pos + (size - number_size) / 2, .size = number_size };
+		}
+	}
+}
+
+bool layout_update(tile_layout* layout, const camera& cam, const Minesweeper* game, const glyph_set* glyphs)
+{
+	const float scale = camera_scale(cam);
+
+	const bool unchanged = 
+		layout->scale == scale && layout->camera_x == cam.x && layout->camera_y == cam.y &&
+		layout->viewport_w == cam.viewport_w && layout->viewport_h == cam.viewport_h &&
+		layout->board_width == game->width && layout->board_height == game->height &&
+		layout->glyph_tile_size == glyphs->tile_size;
+
+	if(unchanged)
+		return false;
+
+	layout->scale = scale;
+	layout->camera_x = cam.x;
+	layout->camera_y = cam.y;
+	layout->viewport_w = cam.viewport_w;
+	layout->viewport_h = cam.viewport_h;
+	layout->board_width = game->width;
+	layout->board_height = game->height;
+	layout->glyph_tile_size = glyphs->tile_size;
+
+	layout->visible = camera_visible_tiles(cam, game);
+
+	const int tile_pixels = (int)std::lround(TILE_HEIGHT * scale);
+	const float glyph_scale = (float)tile_pixels / glyphs->tile_size;
+
+	build_axis(layout->bound_cols, layout->inside_cols, layout->number_cols,
+	           layout->visible.first_col, layout->visible.last_col, TILE_PITCH_X, TILE_WIDTH, cam.x, scale,
+	           glyphs, glyph_scale, true);
+	build_axis(layout->bound_rows, layout->inside_rows, layout->number_rows,
+	           layout->visible.first_row, layout->visible.last_row, TILE_PITCH_Y, TILE_HEIGHT, cam.y, scale,
+	           glyphs, glyph_scale, false);
+
+	return true;
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <SDL2/SDL.h>
+
+#include <vector>
+
+#include "camera.hpp"
+#include "glyph_cache.hpp"
+
+// screen position and size of one visible column or row
+struct tile_span
+{
+	int pos, size;
+};
+
+// destination rects of the visible tiles for every tile state
+// the tile grid is separable, so rects are stored as per-column and per-row spans
+struct tile_layout
+{
+	// what the layout was built for, a change in any of these rebuilds it
+	float scale = 0.0f;
+	float camera_x = 0.0f, camera_y = 0.0f;
+	int viewport_w = 0, viewport_h = 0;
+	int board_width = 0, board_height = 0;
+	int glyph_tile_size = 0;
+
+	tile_range visible = {};
+
+	// whole tile, used for the unopened fill and the outline
+	std::vector<tile_span> bound_cols, bound_rows;
+	// bomb and flag sprites
+	std::vector<tile_span> inside_cols, inside_rows;
+	// numbers 1-8 centered in the tile
+	std::vector<tile_span> number_cols[8], number_rows[8];
+};
+
+// rebuilds the layout if the camera, board or glyph set changed since the last call, returns true if it did
+bool layout_update(tile_layout* layout, const camera& cam, const Minesweeper* game, const glyph_set* glyphs);
+
+// col and row are relative to layout->visible
+inline SDL_Rect layout_rect(const std::vector<tile_span>& cols, const std::vector<tile_span>& rows, int col, int row)
+{
+	return { .x = cols[col].pos, .y = rows[row].pos, .w = cols[col].size, .h = rows[row].size };
+}
@@ -0,0 +1,124 @@
+#include <iostream>
+#include <algorithm>
+
+#include "lod.hpp"
+#include "globals.hpp"
+
+// keeps texture memory reasonable on huge boards, 4096x4096 ARGB is 64MB
+constexpr int LOD_MAX_TEXTURE_SIZE = 4096;
+
+constexpr uint32_t LOD_COLOR_BACKGROUND = 0xFFFFFFFF;
+constexpr uint32_t LOD_COLOR_UNOPENED   = 0xFF7F7F7F;
+constexpr uint32_t LOD_COLOR_FLAGGED    = 0xFFFF0000;
+constexpr uint32_t LOD_COLOR_BOMB       = 0xFF000000;
+constexpr uint32_t LOD_COLOR_EMPTY      = 0xFFFFFFFF;
+// tinted so numbered areas stand out from empty ones
+constexpr uint32_t LOD_COLOR_NUMBER     = 0xFFD8D8E8;
+
+static uint32_t tile_color(const Tile& tile, bool dead)
+{
+	if(tile.open) {
+		if(tile.data == TILE_BOMB)  return LOD_COLOR_BOMB;
+		if(tile.data == TILE_EMPTY) return LOD_COLOR_EMPTY;
+		return LOD_COLOR_NUMBER;
+	}
+
+	if(dead && tile.data == TILE_BOMB) return LOD_COLOR_BOMB;
+	if(tile.flagged) return LOD_COLOR_FLAGGED;
+	return LOD_COLOR_UNOPENED;
+}
+
+// average color of the tiles covered by one texel
+static uint32_t block_color(const Minesweeper* game, int texel_x, int texel_y, int block)
+{
+	const int first_row = texel_y * block + 1, last_row = std::min(game->height, first_row + block - 1);
+	const int first_col = texel_x * block + 1, last_col = std::min(game->width,  first_col + block - 1);
+
+	if(first_row > last_row || first_col > last_col)
+		return LOD_COLOR_BACKGROUND;
+
+	if(block == 1)
+		return tile_color(game->tilemap[first_row][first_col], game->dead);
+
+	uint32_t r = 0, g = 0, b = 0, count = 0;
+	for(int row = first_row; row <= last_row; row++) {
+		for(int col = first_col; col <= last_col; col++) {
+			const uint32_t color = tile_color(game->tilemap[row][col], game->dead);
+			r += (color >> 16) & 0xFF;
+			g += (color >> 8)  & 0xFF;
+			b +=  color        & 0xFF;
+			count++;
+		}
+	}
+
+	return 0xFF000000 | (r / count) << 16 | (g / count) << 8 | (b / count);
+}
+
+void lod_create(RenderBackend* backend, lod_map* lod, const Minesweeper* game)
+{
+	const int max_size = std::min(LOD_MAX_TEXTURE_SIZE, backend->max_texture_size());
+
+	lod->block = 1;
+	while((game->width + lod->block - 1) / lod->block > max_size || (game->height + lod->block - 1) / lod->block > max_size)
+		lod->block *= 2;
+
+	lod->tex_w = (game->width  + lod->block - 1) / lod->block;
+	lod->tex_h = (game->height + lod->block - 1) / lod->block;
+
+	lod->tex = backend->create_streaming_texture(lod->tex_w, lod->tex_h);
+
+	lod->dirty_rows.assign(lod->tex_h, true);
+	lod->was_dead = game->dead;
+}
+
+void lod_destroy(RenderBackend* backend, lod_map* lod)
+{
+	backend->destroy_texture(lod->tex);
+	lod->dirty_rows.clear();
+	lod->upload_buffer.clear();
+}
+
+void lod_mark_changes(lod_map* lod, const Minesweeper* game)
+{
+	// dying reveals every bomb
+	if(game->dead != lod->was_dead) {
+		std::fill(lod->dirty_rows.begin(), lod->dirty_rows.end(), true);
+		lod->was_dead = game->dead;
+		return;
+	}
+
+	for(const auto& [row, col] : game->changed_tiles)
+		lod->dirty_rows[(row - 1) / lod->block] = true;
+}
+
+void lod_render(RenderBackend* backend, lod_map* lod, const Minesweeper* game, const SDL_Rect* dst)
+{
+	// upload each run of consecutive dirty rows at once
+	int row = 0;
+	while(row < lod->tex_h) {
+		if(!lod->dirty_rows[row]) {
+			row++;
+			continue;
+		}
+
+		int run_end = row;
+		while(run_end < lod->tex_h && lod->dirty_rows[run_end])
+			run_end++;
+
+		const SDL_Rect update_rect = { .x = 0, .y = row, .w = lod->tex_w, .h = run_end - row };
+		lod->upload_buffer.resize(update_rect.w * update_rect.h);
+
+		for(int texel_y = row; texel_y < run_end; texel_y++) {
+			uint32_t* texels = &lod->upload_buffer[(texel_y - row) * lod->tex_w];
+			for(int texel_x = 0; texel_x < lod->tex_w; texel_x++)
+				texels[texel_x] = block_color(game, texel_x, texel_y, lod->block);
+
+			lod->dirty_rows[texel_y] = false;
+		}
+
+		backend->update_texture(lod->tex, &update_rect, lod->upload_buffer.data(), lod->tex_w * sizeof(uint32_t));
+		row = run_end;
+	}
+
+	backend->copy(lod->tex, NULL, dst);
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <SDL2/SDL.h>
+
+#include <vector>
+
+#include "minesweeper.hpp"
+#include "renderer.hpp"
+
+// zoomed out board drawn from a streaming texture with one texel per block of tiles
+struct lod_map
+{
+	render_texture tex;
+
+	// tiles per texel along each axis, grows so the texture stays under the size limit
+	int block = 1;
+	int tex_w = 0, tex_h = 0;
+
+	// texel rows that need to be uploaded before the next draw
+	std::vector<bool> dirty_rows;
+	bool was_dead = false;
+
+	// texels of the rows being uploaded
+	std::vector<uint32_t> upload_buffer;
+};
+
+void lod_create(RenderBackend* backend, lod_map* lod, const Minesweeper* game);
+void lod_destroy(RenderBackend* backend, lod_map* lod);
+
+// marks texel rows touched by game->changed_tiles, call every frame even when the lod isn't drawn
+void lod_mark_changes(lod_map* lod, const Minesweeper* game);
+
+// uploads dirty rows and stretches the texture over dst, dst covers tex_w * block by tex_h * block tiles
+void lod_render(RenderBackend* backend, lod_map* lod, const Minesweeper* game, const SDL_Rect* dst);
@@ -1,6 +1,12 @@
 #include <iostream>
 #include <vector>
-#include <random>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+#include <cstring>
+#include <chrono>
+#include <string>
+#include <thread>
 
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
@@ -8,6 +14,24 @@
 
 #include "globals.hpp"
 #include "renderer.hpp"
+#include "minesweeper.hpp"
+#include "camera.hpp"
+#include "board_renderer.hpp"
+#include "render_thread.hpp"
+#include "terminal.hpp"
+#include "infinite_board.hpp"
+#include "storage_benchmark.hpp"
+#include "env_benchmark.hpp"
+#include "save.hpp"
+#include "journal.hpp"
+#include "replay.hpp"
+#include "replay_analysis.hpp"
+#include "undo_history.hpp"
+#include "board_snapshot.hpp"
+#include "hint.hpp"
+#include "shared_board.hpp"
+#include "bot_server.hpp"
+#include "bot_plugin.hpp"
 
 #ifdef __EMSCRIPTEN__
 #include <emscripten.h>
@@ -16,193 +40,150 @@
 constexpr int SCREEN_WIDTH = 800;
 constexpr int SCREEN_HEIGHT = 600;
 
-constexpr int GLOBAL_SCALE = 3;
+// in screen pixels
+constexpr int PAN_STEP = 40;
+constexpr int DRAG_THRESHOLD = 4;
 
-constexpr int TILE_WIDTH  = 10 * GLOBAL_SCALE;
-constexpr int TILE_HEIGHT = 10 * GLOBAL_SCALE;
+// time per frame spent opening tiles, a huge opening spreads over several frames instead of freezing one
+constexpr std::chrono::milliseconds REVEAL_BUDGET(4);
 
-constexpr int OUTSIDE_PADDING = 30;
-constexpr int INSIDE_TILE_PADDING = 3;
+constexpr int DEFAULT_BOARD_WIDTH  = 30;
+constexpr int DEFAULT_BOARD_HEIGHT = 16;
+constexpr int DEFAULT_BOMBCOUNT    = 99;
 
-SDL_Window* g_window = nullptr;
-SDL_Renderer* g_renderer = nullptr;
+constexpr int DEFAULT_HEADLESS_FRAMES = 600;
 
-static bool g_running = true;
+// headless runs always play the same board so their frames can be compared between builds
+constexpr uint64_t HEADLESS_SEED = 1;
 
-enum TileData
-{
-    TILE_EMPTY = 0,
-    TILE_1,
-    TILE_2,
-    TILE_3,
-    TILE_4,
-    TILE_5,
-    TILE_6,
-    TILE_7,
-    TILE_8,
-    TILE_BOMB,
-};
+// --compare passes while at most this share of pixels differ, room for font rasterizer differences
+constexpr double COMPARE_MAX_DIFFERING_SHARE = 0.001;
 
-struct Tile {
-	TileData data = TILE_EMPTY;
-	bool open = false;
-	bool flagged = false;
-};
+// F5 writes here unless a save was loaded, then it goes back to that file
+constexpr const char* DEFAULT_SAVE_PATH = "minesweeper.sav";
 
-class Minesweeper {
-	int bombcount;
-public:
-	int width, height;
-	bool dead = false;
+// replay viewer seek steps in milliseconds, , and . for short ones, [ and ] for long ones
+constexpr uint32_t REPLAY_SEEK_SHORT = 5000;
+constexpr uint32_t REPLAY_SEEK_LONG = 60000;
 
-	std::vector<std::vector<Tile>> tilemap;
+// about the same mine density as expert boards
+constexpr double DEFAULT_INFINITE_DENSITY = 0.2;
 
-	Minesweeper(int width, int height, int bombcount) : bombcount(bombcount), width(width), height(height)
-	{
-		// HACK: adding 1 tile to each side to prevent OOB
-		this->tilemap = std::vector<std::vector<Tile>>( 1 + height + 1, std::vector<Tile>(1 + width + 1, Tile() ) );
+// in megabytes, explored chunks beyond this go to disk
+constexpr int DEFAULT_CHUNK_BUDGET = 256;
 
-		// cap bombcount to number of tiles
-		if(this->bombcount > width * height) {
-			this->bombcount = width * height;
-		}
+// sparse enough that one click opens nearly the whole board
+constexpr int DEFAULT_BENCHMARK_SIZE = 4000;
+constexpr int DEFAULT_BENCHMARK_BOMBCOUNT = DEFAULT_BENCHMARK_SIZE * DEFAULT_BENCHMARK_SIZE / 100;
 
-		std::random_device dev;
-		std::mt19937 rng(dev());
+// beginner boards, what bots are usually trained on
+constexpr int DEFAULT_ENV_WIDTH = 9;
+constexpr int DEFAULT_ENV_HEIGHT = 9;
+constexpr int DEFAULT_ENV_BOMBCOUNT = 10;
+constexpr int DEFAULT_ENV_BOARDS = 4096;
 
-		// HACK: skip index 0 to prevent OOB
-		std::uniform_int_distribution<std::mt19937::result_type> random_width(1,  width);
-		std::uniform_int_distribution<std::mt19937::result_type> random_height(1, height);
+// --bot-load defaults, enough connections and requests in flight to keep the server busy
+constexpr int DEFAULT_LOAD_SESSIONS = 64;
+constexpr int DEFAULT_LOAD_REQUESTS = 20000;
+constexpr int DEFAULT_LOAD_PIPELINE = 16;
 
-		// this is not optimal as random will probably generate the same number
-		// which makes this loop take longer than it should
-		int placed_bombs = 0;
-		while(placed_bombs < bombcount)
-		{
-			int r_width  = random_width(rng);
-			int r_height = random_height(rng);
+constexpr int DEFAULT_PLUGIN_GAMES = 10000;
 
-			Tile& tile = this->tilemap[r_height][r_width];
+SDL_Window* g_window = nullptr;
+SDL_Renderer* g_renderer = nullptr;
 
-			if(tile.data != TILE_BOMB) {
-				tile.data = TILE_BOMB;
-				placed_bombs++;
-			}
-		}
+static bool g_running = true;
 
-		for(int i = 1; i <= height; i++) {
-			for(int j = 1; j <= width; j++) {
-				if(this->tilemap[i][j].data == TILE_BOMB)
-					continue;
-
-				// collect tile neighbors for calculating numbers
-				const Tile neighbors[] = {
-					this->tilemap[i - 1][j - 1], this->tilemap[i - 1][j], this->tilemap[i - 1][j + 1],
-					this->tilemap[i][j - 1],   /*this->Tilemap[i][j],*/   this->tilemap[i][j + 1],
-					this->tilemap[i + 1][j - 1], this->tilemap[i + 1][j], this->tilemap[i + 1][j + 1]
-				};
-
-				int tile_number = 0;
-				for(const Tile& neighbor : neighbors) {
-					if(neighbor.data == TILE_BOMB)
-						tile_number++;
-				}
+// refreshes the viewport and dpi scale, the window may have been resized or moved to another display
+void camera_update_viewport(camera& cam, int output_w, int output_h)
+{
+	cam.viewport_w = output_w;
+	cam.viewport_h = output_h;
 
-				this->tilemap[i][j].data = (TileData)tile_number;
-			}
-		}
-	}
+	int window_w = 0, window_h = 0;
+	if(g_window)
+		SDL_GetWindowSize(g_window, &window_w, &window_h);
+	cam.dpi_scale = window_w > 0 ? (float)cam.viewport_w / window_w : 1.0f;
+}
 
-	void open_tile(int row, int col)
-	{
-		if (this->dead) return;
-
-		Tile* tile = &this->tilemap[row][col];
-		if(!tile->flagged && !tile->open) {
-			printf("opening (%i,%i)\n", row, col);
-			tile->open = true;
-
-			// open neighboring empty tiles
-			if (tile->data == TILE_EMPTY) {
-				for (int i = -1; i <= 1; i++) {
-					for (int j = -1; j <= 1; j++) {
-						if (i == 0 && j == 0) continue;
-						if ( (row + i < 1 || col + j < 1) || (row + i > height || col + j > width)) continue;
-						
-						open_tile(row + i, col + j);
-					}
-				}
-			}
-			else if (tile->data == TILE_BOMB) {
-				this->dead = true;
-			}
-		}
-	}
+struct game_context 
+{
+	Minesweeper* game;
+	camera cam;
+	bool show_minimap = true;
 
-	void flag_tile(int row, int col) {
-		if (this->dead) return;
+	int board_width, board_height, bombcount;
+	const char* save_path = DEFAULT_SAVE_PATH;
 
-		if(row > height) return;
-		if(col > width) return;
+	// every move is recorded here when autosaving
+	journal* log = nullptr;
+	replay_recorder* recorder = nullptr;
 
-		Tile* tile = &this->tilemap[row][col];
-		if(!tile->open) {
-			tile->flagged = !tile->flagged;
-		}
-	}
+	// when watching a replay the board belongs to the player and input only moves the camera
+	replay_player* player = nullptr;
 
-	bool pixel_to_tile(int x, int y, int* row, int* column) {
-		int bound_x = OUTSIDE_PADDING + (this->width  * TILE_WIDTH)  + this->width;
-		int bound_y = OUTSIDE_PADDING + (this->height * TILE_HEIGHT) + this->height;
+	// practice mode, every move can be taken back
+	undo_history* history = nullptr;
 
-		if (x < OUTSIDE_PADDING || y < OUTSIDE_PADDING ||
-			x > bound_x || y > bound_y) 
-		{
-			return false;
-		}
+	// created by the first hint, kept in sync from then on so later hints start right away
+	snapshot_source* snapshots = nullptr;
+	hint_worker hint;
 
-		*row 	= (y - (y % (TILE_HEIGHT + 1))) / (TILE_HEIGHT + 1);
-		*column = (x - (x % (TILE_WIDTH  + 1))) / (TILE_WIDTH  + 1);
+	// the visible board published for other processes
+	shared_board_writer* shm = nullptr;
+	uint32_t replay_time = 0;
+	uint32_t replay_last_ticks = 0;
+	bool replay_paused = false;
 
-		return true;
-	}
-};
+	// frames are drawn either right here or by the render thread from a mirror of the board
+	render_context renderer;
+	render_thread* thread = nullptr;
 
-struct number_texture
-{
-	SDL_Texture* tex;
-	int w, h;
-};
+	// what the render thread was last sent
+	bool sent_dead = false;
+	camera sent_cam;
+	bool sent_show_minimap = true;
 
-struct game_context 
-{
-	Minesweeper* game;
-	SDL_Texture* bomb;
-	SDL_Texture* flag;
-	number_texture numbers[8];
+	// SDL timestamp of the oldest input handled since the last frame, 0 if none
+	uint32_t input_ticks = 0;
+	input_latency latency;
 };
 
-bool initialize_sdl()
+// with a render thread the window's renderer is created there instead
+bool create_window(bool create_renderer)
 {
-	int sdl_status = SDL_Init(SDL_INIT_VIDEO | SDL_INIT_EVENTS);
-	if(sdl_status < 0) {
-		std::cout << "Could not initialize SDL, ERROR: " << SDL_GetError() << "\n";
-		return false;
-	}
-
-	g_window = SDL_CreateWindow("Test", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, SCREEN_WIDTH, SCREEN_HEIGHT, SDL_WINDOW_RESIZABLE);
+	g_window = SDL_CreateWindow("Test", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, SCREEN_WIDTH, SCREEN_HEIGHT, SDL_WINDOW_RESIZABLE | SDL_WINDOW_ALLOW_HIGHDPI);
 
 	if(g_window == NULL) {
 		std::cout << "Could not create window, ERROR:" << SDL_GetError() << "\n";
 		return false;
 	}
 
+	if(!create_renderer)
+		return true;
+
+
 	g_renderer = SDL_CreateRenderer(g_window, -1, SDL_RENDERER_ACCELERATED);
 	if(g_renderer == NULL) {
 		std::cout << "Could not create renderer, ERROR:" << SDL_GetError() << "\n";
 		return false;
 	}	
 
+	return true;
+}
+
+// headless runs render offscreen and don't need a display
+bool initialize_sdl(bool windowed, bool create_renderer)
+{
+	int sdl_status = SDL_Init(windowed ? SDL_INIT_VIDEO | SDL_INIT_EVENTS : SDL_INIT_EVENTS);
+	if(sdl_status < 0) {
+		std::cout << "Could not initialize SDL, ERROR: " << SDL_GetError() << "\n";
+		return false;
+	}
+
+	if(windowed && !create_window(create_renderer))
+		return false;
+
 	if(TTF_Init() < 0) {
 		std::cout << "Could not initialize SDL_TTF, ERROR: " << TTF_GetError() << "\n";
 		return false;
@@ -222,28 +203,223 @@ bool rmb_wasdown;
 bool lmb_isdown;
 bool lmb_wasdown;
 
-void handle_input(Minesweeper* &game)
+// left button drags pan the camera, a click only opens a tile if the mouse barely moved
+bool lmb_dragging;
+int lmb_down_x, lmb_down_y;
+
+// the render thread's mirror starts out blank, so a board that already has progress is sent over like any other change
+void send_whole_board(game_context* context)
+{
+	Minesweeper* game = context->game;
+	for(int row = 1; row <= game->height; row++)
+		for(int col = 1; col <= game->width; col++)
+			if(game->tilemap[row][col].open || game->tilemap[row][col].flagged)
+				game->changed_tiles.push_back({row, col});
+}
+
+// context->game points at a different board now
+void board_replaced(game_context* context)
 {
+	context->sent_dead = false;
+
+	if(context->thread) {
+		render_thread_push(context->thread, {.type = RENDER_NEW_GAME, .width = context->game->width, .height = context->game->height});
+		send_whole_board(context);
+	}
+	else {
+		render_set_board(&context->renderer, context->game);
+	}
+
+	if(context->snapshots)
+		snapshot_reset(context->snapshots, context->game);
+
+	if(context->shm)
+		shared_board_reset(context->shm, context->game);
+}
+
+void start_new_game(game_context* context)
+{
+	if(context->recorder)
+		replay_record_game_over(context->recorder, context->game, SDL_GetTicks());
+
+	delete context->game;
+	context->game = new Minesweeper(context->board_width, context->board_height, context->bombcount);
+
+	if(context->log)
+		journal_snapshot(context->log, context->game);
+
+	if(context->recorder)
+		replay_record_new_game(context->recorder, context->game, SDL_GetTicks());
+
+	if(context->history)
+		undo_reset(context->history, context->game);
+
+	board_replaced(context);
+}
+
+// searches a snapshot for a safe tile near the middle of the view on the hint thread
+void request_hint(game_context* context)
+{
+	if(context->hint.running)
+		return;
+
+	if(!context->snapshots) {
+		context->snapshots = new snapshot_source();
+		snapshot_reset(context->snapshots, context->game);
+	}
+
+	const tile_range visible = camera_visible_tiles(context->cam, context->game);
+	hint_start(&context->hint, snapshot_take(context->snapshots),
+		(visible.first_row + visible.last_row) / 2, (visible.first_col + visible.last_col) / 2);
+}
+
+void show_hint(game_context* context)
+{
+	const hint_worker& hint = context->hint;
+	if(!hint.found) {
+		std::cout << "No tile can be proven safe\n";
+		return;
+	}
+
+	std::cout << "Row " << hint.row << ", column " << hint.col << " is safe\n";
+	if(hint.row <= context->game->height && hint.col <= context->game->width)
+		camera_center_tile(context->cam, context->game, hint.row, hint.col);
+}
+
+void undo_or_redo(game_context* context, bool undo)
+{
+	const bool was_dead = context->game->dead;
+	const bool changed = undo ? undo_step(context->history, context->game) : redo_step(context->history, context->game);
+
+	// the render thread can't take back a lost game, it gets the whole board again instead
+	if(changed && was_dead && !context->game->dead)
+		board_replaced(context);
+}
+
+// call before the move is applied, the undo history closes the previous move here
+void log_move(game_context* context, journal_action action, int row, int col)
+{
+	// the rest of an opening in progress belongs to the move before, the new one would finish it anyway
+	context->game->finish_reveal();
+
+	if(context->history)
+		undo_begin_move(context->history, context->game);
+
+	if(context->log)
+		journal_log(context->log, action, row, col);
+
+	if(context->recorder)
+		replay_record_move(context->recorder, action, row, col, SDL_GetTicks());
+}
+
+void replay_seek_by(game_context* context, int64_t delta)
+{
+	const int64_t duration = context->player->header->duration_ms;
+	context->replay_time = (uint32_t)std::clamp<int64_t>((int64_t)context->replay_time + delta, 0, duration);
+}
+
+void handle_input(game_context* context)
+{
+	Minesweeper* &game = context->game;
+	camera& cam = context->cam;
+
 	SDL_Event event;
 	while (SDL_PollEvent(&event) != 0) {
 		if (event.type == SDL_QUIT) {
 			g_running = false;
 		}
 
+		const bool is_input = event.type == SDL_KEYDOWN || event.type == SDL_MOUSEWHEEL ||
+			event.type == SDL_MOUSEBUTTONDOWN || event.type == SDL_MOUSEBUTTONUP || (event.type == SDL_MOUSEMOTION && lmb_isdown);
+		if (is_input && context->input_ticks == 0)
+			context->input_ticks = std::max<uint32_t>(event.common.timestamp, 1);
+
 		switch(event.type)
 		{
 			case SDL_KEYDOWN:
 			{
 				SDL_KeyboardEvent keyevent = event.key;
-				if(keyevent.keysym.sym == SDLK_ESCAPE)
+				switch(keyevent.keysym.sym)
 				{
-					g_running = false;
-					break;
+					case SDLK_ESCAPE:
+						g_running = false;
+						break;
+
+					case SDLK_m:
+						context->show_minimap = !context->show_minimap;
+						break;
+
+					case SDLK_F5:
+						// a save has no pending opening, --load would leave it half done
+						game->finish_reveal();
+						if(save_game(game, context->save_path))
+							std::cout << "Saved to " << context->save_path << "\n";
+						break;
+
+					case SDLK_SPACE:
+						context->replay_paused = !context->replay_paused;
+						break;
+
+					case SDLK_COMMA:        if(context->player) replay_seek_by(context, -(int64_t)REPLAY_SEEK_SHORT); break;
+					case SDLK_PERIOD:       if(context->player) replay_seek_by(context,  (int64_t)REPLAY_SEEK_SHORT); break;
+					case SDLK_LEFTBRACKET:  if(context->player) replay_seek_by(context, -(int64_t)REPLAY_SEEK_LONG);  break;
+					case SDLK_RIGHTBRACKET: if(context->player) replay_seek_by(context,  (int64_t)REPLAY_SEEK_LONG);  break;
+					case SDLK_HOME:         context->replay_time = 0; break;
+
+					case SDLK_h:
+						request_hint(context);
+						break;
+
+					// ctrl+z undoes, ctrl+shift+z or ctrl+y redoes
+					case SDLK_z:
+						if(context->history && (keyevent.keysym.mod & KMOD_CTRL))
+							undo_or_redo(context, !(keyevent.keysym.mod & KMOD_SHIFT));
+						break;
+
+					case SDLK_y:
+						if(context->history && (keyevent.keysym.mod & KMOD_CTRL))
+							undo_or_redo(context, false);
+						break;
+
+					case SDLK_LEFT:  case SDLK_a: camera_pan(cam, game, -PAN_STEP * cam.dpi_scale, 0); break;
+					case SDLK_RIGHT: case SDLK_d: camera_pan(cam, game,  PAN_STEP * cam.dpi_scale, 0); break;
+					case SDLK_UP:    case SDLK_w: camera_pan(cam, game, 0, -PAN_STEP * cam.dpi_scale); break;
+					case SDLK_DOWN:  case SDLK_s: camera_pan(cam, game, 0,  PAN_STEP * cam.dpi_scale); break;
+
+					default:
+						break;
 				}
 		
 				break;
 			}
 
+			case SDL_MOUSEWHEEL:
+			{
+				int x = 0, y = 0;
+				SDL_GetMouseState(&x, &y);
+				camera_zoom_at(cam, game, window_to_output(cam, x), window_to_output(cam, y), std::pow(ZOOM_STEP, event.wheel.preciseY));
+				break;
+			}
+
+			case SDL_MOUSEMOTION:
+			{
+				if (!lmb_isdown)
+					break;
+
+				SDL_MouseMotionEvent motion_event = event.motion;
+				if (!lmb_dragging && 
+					(std::abs(motion_event.x - lmb_down_x) > DRAG_THRESHOLD || std::abs(motion_event.y - lmb_down_y) > DRAG_THRESHOLD))
+				{
+					lmb_dragging = true;
+					camera_pan(cam, game, (lmb_down_x - motion_event.x) * cam.dpi_scale, (lmb_down_y - motion_event.y) * cam.dpi_scale);
+				} 
+				else if (lmb_dragging) 
+				{
+					camera_pan(cam, game, -motion_event.xrel * cam.dpi_scale, -motion_event.yrel * cam.dpi_scale);
+				}
+				break;
+			}
+
 			case SDL_MOUSEBUTTONDOWN:
 			{
 				SDL_MouseButtonEvent mouse_event = event.button;
@@ -252,17 +428,29 @@ void handle_input(Minesweeper* &game)
 
 				switch (button) 
 				{
+					case SDL_BUTTON_LEFT:
+					{
+						lmb_isdown = true;
+						lmb_dragging = false;
+						lmb_down_x = x;
+						lmb_down_y = y;
+						break;
+					}
 					case SDL_BUTTON_RIGHT:
 					{
 						int row = 0, col = 0;
-						if(game->pixel_to_tile(x, y, &row, &col)) {
+						if(!context->player && pixel_to_tile(cam, game, window_to_output(cam, x), window_to_output(cam, y), &row, &col)) {
+							log_move(context, JOURNAL_FLAG, row, col);
 							game->flag_tile(row, col);
 						}
 						break;
 					}
 					case SDL_BUTTON_MIDDLE: {
-						delete game;
-						game = new Minesweeper(30, 16, 99);
+						if(context->player)
+							break;
+
+						start_new_game(context);
+						camera_clamp(cam, game);
 						break;
 					}
 
@@ -283,9 +471,14 @@ void handle_input(Minesweeper* &game)
 				{
 					case SDL_BUTTON_LEFT:
 					{
+						lmb_isdown = false;
+						if (lmb_dragging)
+							break;
+
 						int row = 0, col = 0;
-						if(game->pixel_to_tile(x, y, &row, &col)) {
-							game->open_tile(row, col);
+						if(!context->player && pixel_to_tile(cam, game, window_to_output(cam, x), window_to_output(cam, y), &row, &col)) {
+							log_move(context, JOURNAL_OPEN, row, col);
+							game->queue_open(row, col);
 						}
 						break;
 					}
@@ -304,143 +497,190 @@ void handle_input(Minesweeper* &game)
 		
 } 
 
+// hands this frame's changes to the render thread, the mirror board only ever sees tiles that changed
+void send_frame(game_context* context)
+{
+	Minesweeper* game = context->game;
+	render_thread* thread = context->thread;
+
+	for(auto [row, col] : game->changed_tiles)
+		render_thread_push(thread, {.type = RENDER_TILE, .tile = game->tilemap[row][col], .row = row, .col = col});
+	game->changed_tiles.clear();
+
+	// the mirror doesn't know where the unopened bombs are until the game is lost
+	if(game->dead && !context->sent_dead) {
+		for(int row = 1; row <= game->height; row++)
+			for(int col = 1; col <= game->width; col++)
+				if(game->tilemap[row][col].data == TILE_BOMB && !game->tilemap[row][col].open)
+					render_thread_push(thread, {.type = RENDER_TILE, .tile = game->tilemap[row][col], .row = row, .col = col});
+
+		render_thread_push(thread, {.type = RENDER_DEAD});
+		context->sent_dead = true;
+	}
+
+	const camera& cam = context->cam;
+	const camera& sent = context->sent_cam;
+	const bool view_changed = cam.x != sent.x || cam.y != sent.y || cam.zoom != sent.zoom || cam.dpi_scale != sent.dpi_scale ||
+		cam.viewport_w != sent.viewport_w || cam.viewport_h != sent.viewport_h || context->show_minimap != context->sent_show_minimap;
+
+	if(view_changed) {
+		render_thread_push(thread, {.type = RENDER_VIEW, .cam = cam, .show_minimap = context->show_minimap});
+		context->sent_cam = cam;
+		context->sent_show_minimap = context->show_minimap;
+	}
+
+	if(context->input_ticks)
+		render_thread_push(thread, {.type = RENDER_FRAME, .input_ticks = context->input_ticks});
+}
+
+// plays the replay in real time and applies seeks from the keyboard
+void update_replay(game_context* context)
+{
+	replay_player* player = context->player;
+
+	const uint32_t ticks = SDL_GetTicks();
+	if(!context->replay_paused)
+		replay_seek_by(context, ticks - context->replay_last_ticks);
+	context->replay_last_ticks = ticks;
+
+	if(context->replay_time == player->time_ms)
+		return;
+
+	const bool was_dead = player->board->dead;
+	const bool replaced = replay_seek(player, context->replay_time);
+	context->game = player->board;
+
+	// the render thread can't take back a lost game, it gets the whole board again instead
+	if(replaced || (was_dead && !player->board->dead))
+		board_replaced(context);
+}
+
 void game_loop(void* ctx)
 {
 	game_context* context = (game_context*)ctx;
 	Minesweeper* &game = context->game;
+	camera& cam = context->cam;
 
-	handle_input(game);
-	SDL_RenderClear(g_renderer);
+	handle_input(context);
 
-	// HACK: starting at index 1 due the hack when generating bombs
-	for(int column = 1; column <= game->height; column++) 
-	{
-		for(int row = 1; row <= game->width; row++) 
-		{
-			const int tile_xpos = (row    - 1) * TILE_WIDTH  + OUTSIDE_PADDING + (row    - 1);
-			const int tile_ypos = (column - 1) * TILE_HEIGHT + OUTSIDE_PADDING + (column - 1);
-
-			Tile& tile = game->tilemap[column][row];
-
-			int tile_number = tile.data - 1;
-			
-			const SDL_Rect bound_rect = {
-				.x = tile_xpos,
-				.y = tile_ypos,
-				.w = TILE_WIDTH,
-				.h = TILE_HEIGHT
-			};
-			
-			if(tile.open) {
-				if(tile.data != TILE_BOMB && tile.data != TILE_EMPTY) {
-					int tile_width = context->numbers[tile_number].w;
-					int tile_height = context->numbers[tile_number].h;
-
-					const SDL_Rect number_rect = {
-						.x = tile_xpos + (bound_rect.w - tile_width) / 2,
-						.y = tile_ypos + (bound_rect.h - tile_height) / 2,
-						.w = tile_width, 
-						.h = tile_height
-					};
-					SDL_RenderCopy(g_renderer, context->numbers[tile_number].tex, NULL, &number_rect);
-				} else if(tile.data == TILE_BOMB) {
-					const SDL_Rect bomb_rect = {
-						.x = bound_rect.x + INSIDE_TILE_PADDING,
-						.y = bound_rect.y + INSIDE_TILE_PADDING,
-						.w = TILE_WIDTH  - (INSIDE_TILE_PADDING * 2),
-						.h = TILE_HEIGHT - (INSIDE_TILE_PADDING * 2)
-					};
-					SDL_RenderCopy(g_renderer, context->bomb, NULL, &bomb_rect);
-				}
-			} 
-			else if (game->dead && tile.data == TILE_BOMB) 
-			{
-				const SDL_Rect bomb_rect = {
-					.x = bound_rect.x + INSIDE_TILE_PADDING,
-					.y = bound_rect.y + INSIDE_TILE_PADDING,
-					.w = TILE_WIDTH  - (INSIDE_TILE_PADDING * 2),
-					.h = TILE_HEIGHT - (INSIDE_TILE_PADDING * 2)
-				};
-				SDL_RenderCopy(g_renderer, context->bomb, NULL, &bomb_rect);
-			}
-			else 
-			{
-				render_filled_rect(g_renderer, &bound_rect, 127, 127, 127);
-				if(tile.flagged) {
-					const SDL_Rect flag_rect = {
-						.x = bound_rect.x + INSIDE_TILE_PADDING,
-						.y = bound_rect.y + INSIDE_TILE_PADDING,
-						.w = TILE_WIDTH  - (INSIDE_TILE_PADDING * 2),
-						.h = TILE_HEIGHT - (INSIDE_TILE_PADDING * 2)
-					};
-					SDL_RenderCopy(g_renderer, context->flag, NULL, &flag_rect);
-				}
-			}
+	if(context->player)
+		update_replay(context);
 
-			render_rect_with_color(g_renderer, &bound_rect, 0, 0, 0);
-		}
+	// tiles opened so far show up this frame, the rest of the opening continues next frame
+	game->reveal_step(std::chrono::steady_clock::now() + REVEAL_BUDGET);
+
+	if(context->log)
+		journal_update(context->log, game);
+
+	if(context->recorder)
+		replay_record_update(context->recorder, game, SDL_GetTicks());
+
+	if(context->history)
+		undo_track(context->history, game);
+
+	if(context->snapshots)
+		snapshot_sync(context->snapshots, game);
+
+	if(context->shm)
+		shared_board_publish(context->shm, game);
+
+	if(hint_poll(&context->hint))
+		show_hint(context);
+
+	int output_w = 0, output_h = 0;
+	if(context->thread) {
+		output_w = context->thread->output_w;
+		output_h = context->thread->output_h;
+	} else {
+		context->renderer.backend->output_size(&output_w, &output_h);
 	}
 
-	SDL_RenderPresent(g_renderer);
+	camera_update_viewport(cam, output_w, output_h);
+	camera_clamp(cam, game);
+
+	if(context->thread) {
+		send_frame(context);
+	} else {
+		context->renderer.cam = cam;
+		context->renderer.show_minimap = context->show_minimap;
+		render_frame(&context->renderer);
+
+		if(context->input_ticks)
+			latency_record(&context->latency, context->input_ticks);
+	}
+
+	context->input_ticks = 0;
 }
 
-int main( [[maybe_unused]] int argc, [[maybe_unused]] char* argv[])
+// scripted input for headless runs: open the middle of the board, then keep panning and zooming
+void headless_step(game_context* context, int frame)
 {
-	if(!initialize_sdl())
-		free_and_quit();
+	camera& cam = context->cam;
 
-	SDL_SetRenderDrawColor(g_renderer, 255, 255, 255, SDL_ALPHA_OPAQUE);
+	if(frame == 0)
+		context->game->open_tile((context->game->height + 1) / 2, (context->game->width + 1) / 2);
 
-	//TODO: variable font pt size?
-	TTF_Font* test_font = TTF_OpenFont("assets/Rubik-Medium.ttf", 28);
+	camera_pan(cam, context->game, 8.0f, 4.0f);
 
-	if(!test_font) {
-		std::cout << "Couldn't load font, ERROR: " << TTF_GetError() << "\n";
-		free_and_quit();
-	}
+	if(frame % 240 == 120)
+		camera_zoom_at(cam, context->game, cam.viewport_w / 2, cam.viewport_h / 2, 0.5f);
+	else if(frame % 240 == 0)
+		camera_zoom_at(cam, context->game, cam.viewport_w / 2, cam.viewport_h / 2, 2.0f);
+}
 
-	game_context context = {};
+// --compare: checks the last headless frame against a reference image saved with --save
+bool compare_frame(SDL_Surface* frame, const char* reference_path)
+{
+	SDL_Surface* reference = SDL_LoadBMP(reference_path);
+	if(reference == NULL) {
+		std::cout << "Couldn't load " << reference_path << ", ERROR: " << SDL_GetError() << "\n";
+		return false;
+	}
 
-	context.bomb = load_and_render_image_to_texture(g_renderer, "assets/bomb.png");
-	context.flag = load_and_render_image_to_texture(g_renderer, "assets/flag.png");
+	const int differing = count_differing_pixels(frame, reference);
+	SDL_FreeSurface(reference);
+	if(differing < 0) {
+		std::cout << reference_path << " isn't the size of the frame\n";
+		return false;
+	}
 
-	constexpr SDL_Color number_colors[] = {
-		{0,0,255,255}, {0,128,0,255}, {255,0,0,255},
-		{0,0,128,255}, {128,0,0,255}, {0,128,128,255},
-		{0,0,0,255},   {128,128,128,255}
-	};
+	const int allowed = (int)(frame->w * frame->h * COMPARE_MAX_DIFFERING_SHARE);
+	printf("%d pixels differ from %s, %d allowed\n", differing, reference_path, allowed);
+	return differing <= allowed;
+}
 
-	for (int i = 0; i <= 7; i++) {
-		char text[2];
-		snprintf(text, sizeof(text),"%d", i+1);
-		SDL_Texture* texture = render_colored_text(g_renderer, test_font, text, number_colors[i]);
-		int tex_w = 0, tex_h = 0;
-		SDL_QueryTexture(texture, NULL, NULL, &tex_w, &tex_h);
+void run_headless(game_context* context, int frames)
+{
+	const uint64_t freq = SDL_GetPerformanceFrequency();
+	const uint64_t start = SDL_GetPerformanceCounter();
 
-		context.numbers[i] = {
-			.tex = texture,
-			.w = tex_w,
-			.h = tex_h
-		};
+	for(int frame = 0; frame < frames && g_running; frame++) {
+		headless_step(context, frame);
+		game_loop(context);
 	}
 
-	context.game = new Minesweeper(30, 16, 99);
+	const uint64_t elapsed_microseconds = (SDL_GetPerformanceCounter() - start) * 1000000 / freq;
+	printf("%d frames in %.1f ms, %.3f ms per frame\n", frames, elapsed_microseconds / 1000.0, elapsed_microseconds / 1000.0 / frames);
 
-	// calculate minimum window dimensions
-	// TODO: change these on new game
-	int minimum_w = context.game->width  * TILE_WIDTH  + context.game->width  + 2 * OUTSIDE_PADDING;
-	int minimum_h = context.game->height * TILE_HEIGHT + context.game->height + 2 * OUTSIDE_PADDING;
-	SDL_SetWindowMinimumSize(g_window, minimum_w, minimum_h);
+	if(NullRenderBackend* null_backend = dynamic_cast<NullRenderBackend*>(context->renderer.backend)) {
+		const render_stats& stats = null_backend->stats;
+		printf("per frame: %.1f fills, %.1f outlines, %.1f copies, %.1f uploads (%.1f KB)\n",
+			(double)stats.fills / frames, (double)stats.outlines / frames, (double)stats.copies / frames,
+			(double)stats.texture_uploads / frames, stats.uploaded_bytes / 1024.0 / frames);
+	}
+}
 
+void run_windowed(game_context* context)
+{
 #ifdef __EMSCRIPTEN__
-	emscripten_set_main_loop_arg(game_loop, (void*)&context, 0, true);
+	emscripten_set_main_loop_arg(game_loop, (void*)context, 0, true);
 #else
 	const uint64_t freq = SDL_GetPerformanceFrequency();
 	while (g_running)
 	{
 		uint64_t start = SDL_GetPerformanceCounter();
 
-		game_loop(&context);
+		game_loop(context);
 
 		const uint64_t end = SDL_GetPerformanceCounter();
 		uint64_t elapsed_ticks = end - start;
@@ -457,6 +697,427 @@ int main( [[maybe_unused]] int argc, [[maybe_unused]] char* argv[])
 		}
 	}
 #endif
+}
+
+int main(int argc, char* argv[])
+{
+	game_context context = {};
+	context.board_width  = DEFAULT_BOARD_WIDTH;
+	context.board_height = DEFAULT_BOARD_HEIGHT;
+	context.bombcount    = DEFAULT_BOMBCOUNT;
+
+	// --headless=software|null renders a scripted session offscreen and prints frame timings
+	const char* headless = nullptr;
+	const char* save_path = nullptr;
+	const char* compare_path = nullptr;
+	int frames = DEFAULT_HEADLESS_FRAMES;
+
+	// --tty plays in the terminal without SDL
+	bool tty = false;
+
+	// --infinite[=density] plays on an unbounded board, terminal only
+	double infinite_density = 0;
+	int chunk_budget = DEFAULT_CHUNK_BUDGET;
+
+	// --render-thread draws on its own thread, fed through a lock-free queue
+	bool threaded = false;
+
+	// --bench-storage compares tile storage layouts and exits
+	bool bench_storage = false;
+
+	// --load=file.sav resumes a game saved with F5
+	const char* load_path = nullptr;
+
+	// --journal=file.sav autosaves every move and picks the game back up after a crash
+	const char* journal_path = nullptr;
+
+	// --record=file.msr writes a replay of the session, --replay=file.msr watches one
+	const char* record_path = nullptr;
+	const char* replay_path = nullptr;
+
+	// --analyze=path checks replays (or directories of them) and exits
+	std::vector<std::string> analyze_paths;
+
+	// --check-replays=scratch.msr records games with moves made mid opening, checks them and exits
+	const char* check_replays_path = nullptr;
+
+	// --bench-env steps --boards=N training boards with random actions and exits
+	bool bench_env = false;
+	int env_boards = DEFAULT_ENV_BOARDS;
+
+	// --shm=name publishes the board in shared memory, --watch-shm=name follows one and exits with the game
+	const char* shm_name = nullptr;
+	const char* watch_shm_name = nullptr;
+
+	// --bot-server=path serves boards to bots on a Unix socket, --bot-load=path measures one
+	const char* bot_server_path = nullptr;
+	const char* bot_load_path = nullptr;
+	int load_sessions = DEFAULT_LOAD_SESSIONS;
+	int load_requests = DEFAULT_LOAD_REQUESTS;
+	int load_pipeline = DEFAULT_LOAD_PIPELINE;
+	int load_options = 0;
+
+	// --bot-plugin=path.so lets a plugin play --games=N boards and exits
+	const char* bot_plugin_path = nullptr;
+	int plugin_games = DEFAULT_PLUGIN_GAMES;
+	bool plugin_games_given = false;
+
+	// --threads=N for --analyze and --bench-env
+	int worker_threads = (int)std::max(1u, std::thread::hardware_concurrency());
+
+	// --practice[=MB] enables undo, keeping up to MB of history
+	int undo_memory = 0;
+
+	int positional[3];
+	int positional_count = 0;
+	bool valid_args = true;
+
+	for(int i = 1; i < argc; i++) {
+		if(std::strcmp(argv[i], "--tty") == 0)
+			tty = true;
+		else if(std::strcmp(argv[i], "--infinite") == 0)
+			infinite_density = DEFAULT_INFINITE_DENSITY;
+		else if(std::strncmp(argv[i], "--infinite=", 11) == 0)
+			infinite_density = std::atof(argv[i] + 11);
+		else if(std::strncmp(argv[i], "--chunk-budget=", 15) == 0)
+			chunk_budget = std::atoi(argv[i] + 15);
+		else if(std::strcmp(argv[i], "--render-thread") == 0)
+			threaded = true;
+		else if(std::strcmp(argv[i], "--bench-storage") == 0)
+			bench_storage = true;
+		else if(std::strncmp(argv[i], "--load=", 7) == 0)
+			load_path = argv[i] + 7;
+		else if(std::strncmp(argv[i], "--journal=", 10) == 0)
+			journal_path = argv[i] + 10;
+		else if(std::strncmp(argv[i], "--record=", 9) == 0)
+			record_path = argv[i] + 9;
+		else if(std::strncmp(argv[i], "--replay=", 9) == 0)
+			replay_path = argv[i] + 9;
+		else if(std::strncmp(argv[i], "--analyze=", 10) == 0)
+			analyze_paths.push_back(argv[i] + 10);
+		else if(std::strncmp(argv[i], "--check-replays=", 16) == 0)
+			check_replays_path = argv[i] + 16;
+		else if(std::strncmp(argv[i], "--threads=", 10) == 0)
+			worker_threads = std::atoi(argv[i] + 10);
+		else if(std::strncmp(argv[i], "--shm=", 6) == 0)
+			shm_name = argv[i] + 6;
+		else if(std::strncmp(argv[i], "--watch-shm=", 12) == 0)
+			watch_shm_name = argv[i] + 12;
+		else if(std::strncmp(argv[i], "--bot-server=", 13) == 0)
+			bot_server_path = argv[i] + 13;
+		else if(std::strncmp(argv[i], "--bot-load=", 11) == 0)
+			bot_load_path = argv[i] + 11;
+		else if(std::strncmp(argv[i], "--bot-plugin=", 13) == 0)
+			bot_plugin_path = argv[i] + 13;
+		else if(std::strncmp(argv[i], "--games=", 8) == 0) {
+			plugin_games = std::atoi(argv[i] + 8);
+			plugin_games_given = true;
+		}
+		else if(std::strncmp(argv[i], "--sessions=", 11) == 0) {
+			load_sessions = std::atoi(argv[i] + 11);
+			load_options++;
+		}
+		else if(std::strncmp(argv[i], "--requests=", 11) == 0) {
+			load_requests = std::atoi(argv[i] + 11);
+			load_options++;
+		}
+		else if(std::strncmp(argv[i], "--pipeline=", 11) == 0) {
+			load_pipeline = std::atoi(argv[i] + 11);
+			load_options++;
+		}
+		else if(std::strcmp(argv[i], "--bench-env") == 0)
+			bench_env = true;
+		else if(std::strncmp(argv[i], "--boards=", 9) == 0)
+			env_boards = std::atoi(argv[i] + 9);
+		else if(std::strcmp(argv[i], "--practice") == 0)
+			undo_memory = DEFAULT_UNDO_MEMORY / (1024 * 1024);
+		else if(std::strncmp(argv[i], "--practice=", 11) == 0)
+			undo_memory = std::atoi(argv[i] + 11);
+		else if(std::strncmp(argv[i], "--headless=", 11) == 0)
+			headless = argv[i] + 11;
+		else if(std::strncmp(argv[i], "--frames=", 9) == 0)
+			frames = std::atoi(argv[i] + 9);
+		else if(std::strncmp(argv[i], "--save=", 7) == 0)
+			save_path = argv[i] + 7;
+		else if(std::strncmp(argv[i], "--compare=", 10) == 0)
+			compare_path = argv[i] + 10;
+		else if(positional_count < 3)
+			positional[positional_count++] = std::atoi(argv[i]);
+		else
+			valid_args = false;
+	}
+
+	if(positional_count == 3) {
+		context.board_width  = positional[0];
+		context.board_height = positional[1];
+		context.bombcount    = positional[2];
+	}
+
+	if(headless && std::strcmp(headless, "software") != 0 && std::strcmp(headless, "null") != 0)
+		valid_args = false;
+
+	if(headless && threaded)
+		valid_args = false;
+
+	// only the software backend has pixels to compare
+	if(compare_path && (!headless || std::strcmp(headless, "software") != 0))
+		valid_args = false;
+
+	// the board comes from the save
+	if(load_path && (tty || positional_count != 0))
+		valid_args = false;
+
+	if(journal_path && (tty || headless || load_path))
+		valid_args = false;
+
+	if((record_path && (tty || headless)) || (replay_path && (tty || headless || load_path || journal_path || record_path || positional_count != 0)))
+		valid_args = false;
+
+	if(!analyze_paths.empty() && (tty || headless || threaded || bench_storage || load_path || journal_path || record_path || replay_path || positional_count != 0 || worker_threads <= 0))
+		valid_args = false;
+
+	if(bench_env && (tty || headless || threaded || bench_storage || load_path || journal_path || record_path || replay_path || !analyze_paths.empty() || worker_threads <= 0 || env_boards <= 0))
+		valid_args = false;
+
+	if((shm_name && tty) || (watch_shm_name && argc != 2) || (check_replays_path && argc != 2))
+		valid_args = false;
+
+	// the server only takes a board size, the load generator only its own options
+	if(bot_server_path && argc != 2 + positional_count)
+		valid_args = false;
+
+	if(bot_load_path && (argc != 2 + load_options || load_sessions <= 0 || load_requests <= 0 || load_pipeline <= 0))
+		valid_args = false;
+
+	if(load_options != 0 && !bot_load_path)
+		valid_args = false;
+
+	if(bot_plugin_path && (argc != 2 + positional_count + plugin_games_given || plugin_games <= 0))
+		valid_args = false;
+
+	if(plugin_games_given && !bot_plugin_path)
+		valid_args = false;
+
+	// a journal or replay of a game with undone moves couldn't be played back
+	if(undo_memory != 0 && (undo_memory < 0 || tty || journal_path || record_path || replay_path))
+		valid_args = false;
+
+	if(infinite_density != 0 && (!tty || infinite_density < INFINITE_MIN_DENSITY || infinite_density > INFINITE_MAX_DENSITY || chunk_budget <= 0))
+		valid_args = false;
+
+	if(!valid_args || (positional_count != 0 && positional_count != 3) || frames <= 0 ||
+		context.board_width <= 0 || context.board_height <= 0 || context.bombcount < 0) 
+	{
+		std::cout << "Usage: " << argv[0] << " [width height bombcount] [--load=file.sav | --journal=file.sav] [--practice[=MB] | --record=file.msr | --replay=file.msr] [--analyze=path... | --check-replays=scratch.msr | --bench-env [--boards=N]] [--threads=N] [--shm=name | --watch-shm=name] [--bot-server=path | --bot-load=path [--sessions=N] [--requests=N] [--pipeline=N] | --bot-plugin=path.so [--games=N]] [--bench-storage | --tty [--infinite[=density] [--chunk-budget=MB]] | --render-thread | --headless=software|null [--frames=N] [--save=frame.bmp] [--compare=frame.bmp]]\n";
+		return EXIT_FAILURE;
+	}
+
+	if(watch_shm_name)
+		return run_shared_board_monitor(watch_shm_name);
+
+	if(bot_server_path)
+		return run_bot_server(bot_server_path, context.board_width, context.board_height, context.bombcount);
+
+	if(bot_load_path)
+		return run_bot_load(bot_load_path, load_sessions, load_requests, load_pipeline);
+
+	if(bot_plugin_path)
+		return run_bot_plugin(bot_plugin_path, context.board_width, context.board_height, context.bombcount, plugin_games);
+
+	if(!analyze_paths.empty())
+		return run_replay_analysis(analyze_paths, worker_threads);
+
+	if(check_replays_path)
+		return run_replay_self_check(check_replays_path);
+
+	if(bench_env && positional_count == 0)
+		return run_env_benchmark(DEFAULT_ENV_WIDTH, DEFAULT_ENV_HEIGHT, DEFAULT_ENV_BOMBCOUNT, env_boards, worker_threads);
+
+	if(bench_env)
+		return run_env_benchmark(context.board_width, context.board_height, context.bombcount, env_boards, worker_threads);
+
+	if(bench_storage && positional_count == 0)
+		return run_storage_benchmark(DEFAULT_BENCHMARK_SIZE, DEFAULT_BENCHMARK_SIZE, DEFAULT_BENCHMARK_BOMBCOUNT);
+
+	if(bench_storage)
+		return run_storage_benchmark(context.board_width, context.board_height, context.bombcount);
+
+	if(tty && infinite_density != 0)
+		return run_terminal_infinite(infinite_density, (size_t)chunk_budget * 1024 * 1024);
+
+	if(tty)
+		return run_terminal(context.board_width, context.board_height, context.bombcount);
+
+	if(!initialize_sdl(headless == nullptr, !threaded))
+		free_and_quit();
+
+	// only used to build the sdf atlas for the number glyphs
+	TTF_Font* test_font = TTF_OpenFont("assets/Rubik-Medium.ttf", 28);
+
+	if(!test_font) {
+		std::cout << "Couldn't load font, ERROR: " << TTF_GetError() << "\n";
+		free_and_quit();
+	}
+
+	// a journal that's already there belongs to a game that didn't exit cleanly, or was just closed
+	uint64_t journal_generation = 0;
+	Minesweeper* recovered = journal_path ? journal_recover(journal_path, &journal_generation) : nullptr;
+
+	if(replay_path) {
+		context.player = new replay_player();
+		if(!replay_open(context.player, replay_path))
+			free_and_quit();
+
+		replay_seek(context.player, 0);
+		context.game = context.player->board;
+		context.game->changed_tiles.clear();
+		context.board_width  = context.game->width;
+		context.board_height = context.game->height;
+		context.bombcount    = context.game->bomb_count();
+		context.replay_last_ticks = SDL_GetTicks();
+	}
+	else if(recovered) {
+		context.game = recovered;
+		context.board_width  = recovered->width;
+		context.board_height = recovered->height;
+		context.bombcount    = recovered->bomb_count();
+		std::cout << "Recovered game from " << journal_path << "\n";
+	}
+	else if(load_path) {
+		save_view view;
+		if(!save_open(&view, load_path))
+			free_and_quit();
+
+		context.game = save_load_game(view);
+		save_close(&view);
+
+		context.board_width  = context.game->width;
+		context.board_height = context.game->height;
+		context.bombcount    = context.game->bomb_count();
+		context.save_path    = load_path;
+	}
+	else if(headless) {
+		context.game = new Minesweeper(context.board_width, context.board_height, context.bombcount, HEADLESS_SEED);
+	}
+	else {
+		context.game = new Minesweeper(context.board_width, context.board_height, context.bombcount);
+	}
+
+	if(journal_path) {
+		context.log = new journal();
+		if(!journal_start(context.log, journal_path, context.game, journal_generation))
+			free_and_quit();
+	}
+
+	if(undo_memory != 0) {
+		context.history = new undo_history();
+		context.history->memory_cap = (size_t)undo_memory * 1024 * 1024;
+		undo_reset(context.history, context.game);
+	}
+
+	if(shm_name) {
+		context.shm = new shared_board_writer();
+		if(!shared_board_create(context.shm, shm_name, context.game))
+			free_and_quit();
+	}
+
+	if(record_path) {
+		context.recorder = new replay_recorder();
+		if(!replay_record_start(context.recorder, record_path, context.game, SDL_GetTicks()))
+			free_and_quit();
+	}
+
+	// --compare failing is reported through the exit code once everything is cleaned up
+	int exit_code = EXIT_SUCCESS;
+
+	SoftwareRenderBackend* software_backend = nullptr;
+	RenderBackend* backend = nullptr;
+	if(threaded) {
+		context.thread = new render_thread();
+		if(!render_thread_start(context.thread, g_window, test_font, context.board_width, context.board_height))
+			free_and_quit();
+
+		send_whole_board(&context);
+	}
+	else {
+		if(!headless)
+			backend = new SdlRenderBackend(g_renderer);
+		else if(std::strcmp(headless, "software") == 0)
+			backend = software_backend = new SoftwareRenderBackend(SCREEN_WIDTH, SCREEN_HEIGHT);
+		else
+			backend = new NullRenderBackend(SCREEN_WIDTH, SCREEN_HEIGHT);
+
+		render_context_init(&context.renderer, backend, test_font);
+		render_set_board(&context.renderer, context.game);
+	}
+
+	// start zoomed out far enough for the whole board to fit
+	int output_w = 0, output_h = 0;
+	if(threaded) {
+		output_w = context.thread->output_w;
+		output_h = context.thread->output_h;
+	} else {
+		backend->output_size(&output_w, &output_h);
+	}
+	camera_update_viewport(context.cam, output_w, output_h);
+	context.cam.zoom = std::min(camera_fit_zoom(context.cam, context.game), DEFAULT_ZOOM);
+	camera_clamp(context.cam, context.game);
+
+	if(headless) {
+		run_headless(&context, frames);
+
+		if(software_backend && save_path && SDL_SaveBMP(software_backend->surface, save_path) < 0)
+			std::cout << "Couldn't save frame, ERROR: " << SDL_GetError() << "\n";
+
+		if(software_backend && compare_path && !compare_frame(software_backend->surface, compare_path))
+			exit_code = EXIT_FAILURE;
+	}
+	else {
+		run_windowed(&context);
+	}
+
+	if(threaded) {
+		render_thread_stop(context.thread);
+		latency_print(&context.thread->latency, "render thread");
+		delete context.thread;
+	}
+	else {
+		if(!headless)
+			latency_print(&context.latency, "single thread");
+
+		render_context_destroy(&context.renderer);
+		delete backend;
+	}
+
+	if(context.log) {
+		journal_stop(context.log);
+		delete context.log;
+	}
+
+	if(context.recorder) {
+		if(replay_record_finish(context.recorder, context.game, SDL_GetTicks()))
+			std::cout << "Replay written to " << record_path << "\n";
+		delete context.recorder;
+	}
+
+	delete context.history;
+
+	hint_stop(&context.hint);
+	delete context.snapshots;
+
+	if(context.shm) {
+		shared_board_destroy(context.shm);
+		delete context.shm;
+	}
+
+	// the player owns its board
+	if(context.player) {
+		replay_close(context.player);
+		delete context.player;
+		context.game = nullptr;
+	}
+
+	delete context.game;
 
 	IMG_Quit();
 
@@ -467,5 +1128,5 @@ int main( [[maybe_unused]] int argc, [[maybe_unused]] char* argv[])
 	SDL_DestroyWindow(g_window);
 	SDL_Quit();
 	
-	return EXIT_SUCCESS;
-}
\ No newline at end of file
+	return exit_code;
+}
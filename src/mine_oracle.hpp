@@ -0,0 +1,49 @@
+#pragma once
+#include <cstdint>
+
+#include "minesweeper.hpp"
+
+// decides if a tile is a mine from (seed, row, col) alone, nothing is stored and any tile can be asked in any order
+struct mine_oracle
+{
+	uint64_t seed;
+
+	// a tile is a mine when its hash is below this, density scaled to the full 64 bit range
+	uint64_t threshold;
+};
+
+// splitmix64 finalizer, every input bit affects every output bit
+inline uint64_t oracle_mix(uint64_t value)
+{
+	value ^= value >> 30;
+	value *= 0xbf58476d1ce4e5b9ull;
+	value ^= value >> 27;
+	value *= 0x94d049bb133111ebull;
+	value ^= value >> 31;
+	return value;
+}
+
+inline mine_oracle make_mine_oracle(uint64_t seed, double density)
+{
+	// 2^64 doesn't fit, a density of 1 saturates instead
+	const double scaled = density * 18446744073709551616.0;
+	return { .seed = oracle_mix(seed), .threshold = scaled >= 18446744073709551615.0 ? UINT64_MAX : (uint64_t)scaled };
+}
+
+inline bool oracle_is_mine(const mine_oracle& oracle, int64_t row, int64_t col)
+{
+	const uint64_t hash = oracle_mix(oracle_mix(oracle.seed ^ (uint64_t)row) ^ (uint64_t)col);
+	return hash < oracle.threshold;
+}
+
+// the tile's number without looking at any stored tiles
+inline TileData oracle_count(const mine_oracle& oracle, int64_t row, int64_t col)
+{
+	int count = 0;
+	for (int i = -1; i <= 1; i++)
+		for (int j = -1; j <= 1; j++)
+			if ((i != 0 || j != 0) && oracle_is_mine(oracle, row + i, col + j))
+				count++;
+
+	return (TileData)count;
+}
@@ -0,0 +1,244 @@
+#include <algorithm>
+#include <random>
+
+#include "minesweeper.hpp"
+
+Minesweeper::Minesweeper(int width, int height, int bombcount, storage_layout layout)
+	: Minesweeper(width, height, bombcount, ((uint64_t)std::random_device()() << 32) | std::random_device()(), layout)
+{
+}
+
+Minesweeper::Minesweeper(int width, int height, int bombcount, uint64_t seed, storage_layout layout)
+	: bombcount(bombcount), width(width), height(height), seed(seed)
+{
+	// HACK: adding 1 tile to each side to prevent OOB
+	this->tilemap = Grid<Tile>(1 + height + 1, 1 + width + 1, layout);
+
+	// cap bombcount to number of tiles
+	if(this->bombcount > width * height) {
+		this->bombcount = width * height;
+	}
+
+	place_mines();
+}
+
+void Minesweeper::new_game(uint64_t seed)
+{
+	this->seed = seed;
+	this->dead = false;
+	this->pending_reveal.clear();
+	this->tilemap.fill(Tile());
+	place_mines();
+
+	if(this->view_plane)
+		attach_view(this->view_plane);
+}
+
+// std::seed_seq's generate for the two seed words, without the heap allocation seed_seq makes to hold them
+// boards have to come out exactly as before, saves and replays only store the seed
+struct mine_seed_sequence
+{
+	using result_type = uint32_t;
+	uint32_t words[2];
+
+	template <typename Iterator>
+	void generate(Iterator begin, Iterator end) const
+	{
+		if(begin == end)
+			return;
+
+		const size_t n = end - begin, s = 2;
+		std::fill(begin, end, 0x8b8b8b8bu);
+
+		const size_t t = n >= 623 ? 11 : n >= 68 ? 7 : n >= 39 ? 5 : n >= 7 ? 3 : (n - 1) / 2;
+		const size_t p = (n - t) / 2, q = p + t;
+		const size_t m = std::max(s + 1, n);
+		auto mix = [](uint32_t x) { return x ^ (x >> 27); };
+
+		for(size_t k = 0; k < m; k++) {
+			const uint32_t r1 = 1664525u * mix(begin[k % n] ^ begin[(k + p) % n] ^ begin[(k + n - 1) % n]);
+			const uint32_t r2 = r1 + (uint32_t)(k == 0 ? s : k <= s ? k % n + words[k - 1] : k % n);
+			begin[(k + p) % n] += r1;
+			begin[(k + q) % n] += r2;
+			begin[k % n] = r2;
+		}
+
+		for(size_t k = m; k < m + n; k++) {
+			const uint32_t r3 = 1566083941u * mix(begin[k % n] + begin[(k + p) % n] + begin[(k + n - 1) % n]);
+			const uint32_t r4 = r3 - (uint32_t)(k % n);
+			begin[(k + p) % n] ^= r3;
+			begin[(k + q) % n] ^= r4;
+			begin[k % n] = r4;
+		}
+	}
+};
+
+void Minesweeper::place_mines()
+{
+	const mine_seed_sequence seed_sequence = { { (uint32_t)seed, (uint32_t)(seed >> 32) } };
+	std::mt19937 rng(seed_sequence);
+
+	// HACK: skip index 0 to prevent OOB
+	std::uniform_int_distribution<std::mt19937::result_type> random_width(1,  width);
+	std::uniform_int_distribution<std::mt19937::result_type> random_height(1, height);
+
+	// this is not optimal as random will probably generate the same number
+	// which makes this loop take longer than it should
+	int placed_bombs = 0;
+	while(placed_bombs < this->bombcount)
+	{
+		int r_width  = random_width(rng);
+		int r_height = random_height(rng);
+
+		Tile& tile = this->tilemap[r_height][r_width];
+
+		if(tile.data != TILE_BOMB) {
+			tile.data = TILE_BOMB;
+			placed_bombs++;
+		}
+	}
+
+	for(int i = 1; i <= height; i++) {
+		for(int j = 1; j <= width; j++) {
+			if(this->tilemap[i][j].data == TILE_BOMB)
+				continue;
+
+			// collect tile neighbors for calculating numbers
+			const Tile neighbors[] = {
+				this->tilemap[i - 1][j - 1], this->tilemap[i - 1][j], this->tilemap[i - 1][j + 1],
+				this->tilemap[i][j - 1],   /*this->Tilemap[i][j],*/   this->tilemap[i][j + 1],
+				this->tilemap[i + 1][j - 1], this->tilemap[i + 1][j], this->tilemap[i + 1][j + 1]
+			};
+
+			int tile_number = 0;
+			for(const Tile& neighbor : neighbors) {
+				if(neighbor.data == TILE_BOMB)
+					tile_number++;
+			}
+
+			this->tilemap[i][j].data = (TileData)tile_number;
+		}
+	}
+}
+
+Minesweeper::Minesweeper(int width, int height, storage_layout layout) : bombcount(0), width(width), height(height)
+{
+	// HACK: adding 1 tile to each side to prevent OOB
+	this->tilemap = Grid<Tile>(1 + height + 1, 1 + width + 1, layout);
+}
+
+void Minesweeper::add_mine(int row, int col)
+{
+	Tile& tile = this->tilemap[row][col];
+	if(tile.data == TILE_BOMB)
+		return;
+
+	tile.data = TILE_BOMB;
+	this->bombcount++;
+
+	// neighbors that are bombs themselves don't show a number
+	for (int i = -1; i <= 1; i++) {
+		for (int j = -1; j <= 1; j++) {
+			if (i == 0 && j == 0) continue;
+			if ( (row + i < 1 || col + j < 1) || (row + i > height || col + j > width)) continue;
+
+			Tile& neighbor = this->tilemap[row + i][col + j];
+			if(neighbor.data != TILE_BOMB)
+				neighbor.data = (TileData)(neighbor.data + 1);
+		}
+	}
+}
+
+void Minesweeper::open_tile(int row, int col)
+{
+	queue_open(row, col);
+	finish_reveal();
+}
+
+void Minesweeper::queue_open(int row, int col)
+{
+	if (this->dead) return;
+
+	finish_reveal();
+	this->pending_reveal.push_back({row, col});
+}
+
+bool Minesweeper::reveal_step(std::chrono::steady_clock::time_point deadline)
+{
+	// reading the clock for every tile would cost more than opening it
+	constexpr int DEADLINE_CHECK_INTERVAL = 4096;
+
+	// explicit stack instead of recursion, big openings would overflow the call stack
+	std::vector<std::pair<int, int>>& pending = this->pending_reveal;
+
+	int opened = 0;
+	while(!pending.empty()) {
+		if(this->dead) {
+			pending.clear();
+			break;
+		}
+
+		if(++opened % DEADLINE_CHECK_INTERVAL == 0 && std::chrono::steady_clock::now() >= deadline)
+			break;
+
+		auto [tile_row, tile_col] = pending.back();
+		pending.pop_back();
+
+		Tile* tile = &this->tilemap[tile_row][tile_col];
+		if(tile->flagged || tile->open)
+			continue;
+
+		tile->open = true;
+		this->changed_tiles.push_back({tile_row, tile_col});
+		refresh_view(tile_row, tile_col);
+
+		// open neighboring empty tiles
+		if (tile->data == TILE_EMPTY) {
+			for (int i = -1; i <= 1; i++) {
+				for (int j = -1; j <= 1; j++) {
+					if (i == 0 && j == 0) continue;
+					if ( (tile_row + i < 1 || tile_col + j < 1) || (tile_row + i > height || tile_col + j > width)) continue;
+
+					const Tile& neighbor = this->tilemap[tile_row + i][tile_col + j];
+					if(!neighbor.open && !neighbor.flagged)
+						pending.push_back({tile_row + i, tile_col + j});
+				}
+			}
+		}
+		else if (tile->data == TILE_BOMB) {
+			this->dead = true;
+		}
+	}
+
+	return !pending.empty();
+}
+
+void Minesweeper::flag_tile(int row, int col)
+{
+	if (this->dead) return;
+
+	if(row > height) return;
+	if(col > width) return;
+
+	finish_reveal();
+
+	Tile* tile = &this->tilemap[row][col];
+	if(!tile->open) {
+		tile->flagged = !tile->flagged;
+		this->changed_tiles.push_back({row, col});
+		refresh_view(row, col);
+	}
+}
+
+void Minesweeper::attach_view(uint8_t* buffer)
+{
+	if(!buffer) {
+		this->owned_view.resize((size_t)width * height);
+		buffer = this->owned_view.data();
+	}
+
+	this->view_plane = buffer;
+	for(int row = 1; row <= height; row++)
+		for(int col = 1; col <= width; col++)
+			refresh_view(row, col);
+}
@@ -0,0 +1,115 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "tile_grid.hpp"
+
+enum TileData : uint8_t
+{
+    TILE_EMPTY = 0,
+    TILE_1,
+    TILE_2,
+    TILE_3,
+    TILE_4,
+    TILE_5,
+    TILE_6,
+    TILE_7,
+    TILE_8,
+    TILE_BOMB,
+};
+
+// what a player sees of a tile, one byte per tile for bots: the number once open, otherwise closed or flagged
+enum TileView : uint8_t
+{
+	// 0 to 8 are the open numbers
+	TILE_VIEW_CLOSED = 9,
+	TILE_VIEW_FLAGGED = 10,
+	TILE_VIEW_MINE = 11, // the one that ended the game
+};
+
+struct Tile {
+	TileData data = TILE_EMPTY;
+	bool open = false;
+	bool flagged = false;
+};
+
+class Minesweeper {
+	int bombcount;
+
+	// flood fill frontier, kept between reveal_step calls so big openings can be spread over frames
+	std::vector<std::pair<int, int>> pending_reveal;
+
+	uint8_t* view_plane = nullptr;
+	std::vector<uint8_t> owned_view;
+
+	// places bombcount mines from seed on a cleared tilemap and numbers the rest
+	void place_mines();
+public:
+	int width, height;
+	bool dead = false;
+
+	// the bombs were placed from this, kept so saves and replays can say which board they belong to
+	uint64_t seed = 0;
+
+	Grid<Tile> tilemap;
+
+	// (row, col) of every tile opened or (un)flagged, renderers consume and clear this each frame
+	std::vector<std::pair<int, int>> changed_tiles;
+
+	Minesweeper(int width, int height, int bombcount, storage_layout layout = STORAGE_ROW_MAJOR);
+	Minesweeper(int width, int height, int bombcount, uint64_t seed, storage_layout layout = STORAGE_ROW_MAJOR);
+
+	// every tile empty and closed, used for boards mirrored from another thread
+	Minesweeper(int width, int height, storage_layout layout = STORAGE_ROW_MAJOR);
+
+	// view_plane can point into the board itself
+	Minesweeper(const Minesweeper&) = delete;
+	Minesweeper& operator=(const Minesweeper&) = delete;
+
+	int bomb_count() const { return bombcount; }
+
+	// starts over with new mines in the same tile storage, the board isn't reallocated
+	// changed_tiles isn't filled, whoever draws the board has to redraw all of it like for a new board
+	void new_game(uint64_t seed);
+
+	// for rebuilding a saved board on a blank one, bumps the numbers around it
+	void add_mine(int row, int col);
+
+	// opens the tile and runs the whole flood fill before returning
+	void open_tile(int row, int col);
+
+	// only queues the tile, reveal_step does the opening
+	// an opening still in progress is finished first, see flag_tile
+	void queue_open(int row, int col);
+
+	// opens queued tiles until the queue is empty or deadline passes, returns true if some are left
+	// every tile is either fully open or untouched in between
+	bool reveal_step(std::chrono::steady_clock::time_point deadline);
+	bool revealing() const { return !pending_reveal.empty(); }
+	void finish_reveal() { reveal_step(std::chrono::steady_clock::time_point::max()); }
+
+	// finishes an opening still in progress first, so a move always lands on a whole board
+	// journals and replays apply moves without frames in between and end up on the same board
+	void flag_tile(int row, int col);
+
+	// one TileView per tile row by row, written only where a tile changes so bots can read it as is
+	// buffer has to hold width * height bytes and outlive the board, nullptr keeps one inside the board
+	void attach_view(uint8_t* buffer = nullptr);
+	const uint8_t* view() const { return view_plane; }
+
+	// for code that changes tiles without going through open and flag, like undo
+	void refresh_view(int row, int col)
+	{
+		if(view_plane)
+			view_plane[(size_t)(row - 1) * width + (col - 1)] = tile_view(tilemap[row][col]);
+	}
+
+	static uint8_t tile_view(const Tile& tile)
+	{
+		if(tile.open)
+			return tile.data == TILE_BOMB ? (uint8_t)TILE_VIEW_MINE : (uint8_t)tile.data;
+		return tile.flagged ? TILE_VIEW_FLAGGED : TILE_VIEW_CLOSED;
+	}
+};
@@ -0,0 +1,97 @@
+#include <iostream>
+#include <algorithm>
+
+#include "minimap.hpp"
+#include "globals.hpp"
+
+constexpr uint32_t MINIMAP_COLOR_UNOPENED = 0xFF7F7F7F;
+constexpr uint32_t MINIMAP_COLOR_OPENED   = 0xFFFFFFFF;
+constexpr uint32_t MINIMAP_COLOR_FLAGGED  = 0xFFFF0000;
+
+// blends from unopened to opened by the share of opened tiles, any flag marks the whole texel
+static uint32_t texel_color(const Minesweeper* game, int texel_x, int texel_y, int block)
+{
+	const int first_row = texel_y * block + 1, last_row = std::min(game->height, first_row + block - 1);
+	const int first_col = texel_x * block + 1, last_col = std::min(game->width,  first_col + block - 1);
+
+	int opened = 0, total = 0;
+	for(int row = first_row; row <= last_row; row++) {
+		for(int col = first_col; col <= last_col; col++) {
+			const Tile& tile = game->tilemap[row][col];
+			if(tile.flagged)
+				return MINIMAP_COLOR_FLAGGED;
+
+			opened += tile.open;
+			total++;
+		}
+	}
+
+	const uint32_t unopened_value = MINIMAP_COLOR_UNOPENED & 0xFF;
+	const uint32_t opened_value   = MINIMAP_COLOR_OPENED & 0xFF;
+	const uint32_t value = unopened_value + (opened_value - unopened_value) * opened / total;
+
+	return 0xFF000000 | value << 16 | value << 8 | value;
+}
+
+void minimap_create(RenderBackend* backend, minimap* map, const Minesweeper* game, int max_size)
+{
+	const int longest_side = std::max(game->width, game->height);
+	map->block = (longest_side + max_size - 1) / max_size;
+	map->tex_w = (game->width  + map->block - 1) / map->block;
+	map->tex_h = (game->height + map->block - 1) / map->block;
+
+	map->tex = backend->create_streaming_texture(map->tex_w, map->tex_h);
+
+	// loaded, recovered and replayed boards can already have progress
+	map->pixels.resize(map->tex_w * map->tex_h);
+	for(int texel_y = 0; texel_y < map->tex_h; texel_y++)
+		for(int texel_x = 0; texel_x < map->tex_w; texel_x++)
+			map->pixels[texel_y * map->tex_w + texel_x] = texel_color(game, texel_x, texel_y, map->block);
+	backend->update_texture(map->tex, NULL, map->pixels.data(), map->tex_w * sizeof(uint32_t));
+
+	map->dirty_texels.clear();
+	map->texel_dirty.assign(map->tex_w * map->tex_h, false);
+}
+
+void minimap_destroy(RenderBackend* backend, minimap* map)
+{
+	backend->destroy_texture(map->tex);
+	map->pixels.clear();
+	map->dirty_texels.clear();
+	map->texel_dirty.clear();
+}
+
+void minimap_mark_changes(minimap* map, const Minesweeper* game)
+{
+	for(const auto& [row, col] : game->changed_tiles) {
+		const int texel = ((row - 1) / map->block) * map->tex_w + (col - 1) / map->block;
+		if(!map->texel_dirty[texel]) {
+			map->texel_dirty[texel] = true;
+			map->dirty_texels.push_back(texel);
+		}
+	}
+}
+
+void minimap_render(RenderBackend* backend, minimap* map, const Minesweeper* game, const SDL_Rect* dst)
+{
+	if(!map->dirty_texels.empty()) {
+		int min_x = map->tex_w, min_y = map->tex_h, max_x = 0, max_y = 0;
+
+		for(int texel : map->dirty_texels) {
+			const int texel_x = texel % map->tex_w, texel_y = texel / map->tex_w;
+			map->pixels[texel] = texel_color(game, texel_x, texel_y, map->block);
+			map->texel_dirty[texel] = false;
+
+			min_x = std::min(min_x, texel_x); max_x = std::max(max_x, texel_x);
+			min_y = std::min(min_y, texel_y); max_y = std::max(max_y, texel_y);
+		}
+		map->dirty_texels.clear();
+
+		// upload only the bounding box of what changed
+		const SDL_Rect update_rect = { .x = min_x, .y = min_y, .w = max_x - min_x + 1, .h = max_y - min_y + 1 };
+		const uint32_t* first_pixel = &map->pixels[min_y * map->tex_w + min_x];
+		backend->update_texture(map->tex, &update_rect, first_pixel, map->tex_w * sizeof(uint32_t));
+	}
+
+	backend->copy(map->tex, NULL, dst);
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <SDL2/SDL.h>
+
+#include <vector>
+
+#include "minesweeper.hpp"
+#include "renderer.hpp"
+
+// small overview of the whole board, kept up to date from game->changed_tiles only
+struct minimap
+{
+	render_texture tex;
+
+	// tiles per texel along each axis
+	int block = 1;
+	int tex_w = 0, tex_h = 0;
+
+	// cpu copy of the texture, dirty regions are uploaded from here
+	std::vector<uint32_t> pixels;
+
+	// texels waiting to be recomputed, texel_dirty avoids queueing one twice
+	std::vector<int> dirty_texels;
+	std::vector<bool> texel_dirty;
+};
+
+void minimap_create(RenderBackend* backend, minimap* map, const Minesweeper* game, int max_size);
+void minimap_destroy(RenderBackend* backend, minimap* map);
+
+// queues the texels touched by game->changed_tiles, call every frame even when the minimap is hidden
+void minimap_mark_changes(minimap* map, const Minesweeper* game);
+
+// recomputes and uploads dirty texels, then draws the map into dst
+void minimap_render(RenderBackend* backend, minimap* map, const Minesweeper* game, const SDL_Rect* dst);
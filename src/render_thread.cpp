@@ -0,0 +1,119 @@
+#include <iostream>
+
+#include "render_thread.hpp"
+
+static void render_thread_main(render_thread* thread, SDL_Window* window, TTF_Font* font, int board_width, int board_height)
+{
+	// the renderer has to be created on the thread that uses it
+	SDL_Renderer* renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+	if(renderer == NULL) {
+		std::cout << "Could not create renderer, ERROR:" << SDL_GetError() << "\n";
+		thread->failed = true;
+		return;
+	}
+
+	SdlRenderBackend backend(renderer);
+
+	render_context context = {};
+	render_context_init(&context, &backend, font);
+	render_set_board(&context, new Minesweeper(board_width, board_height));
+
+	int output_w = 0, output_h = 0;
+	backend.output_size(&output_w, &output_h);
+	thread->output_w = output_w;
+	thread->output_h = output_h;
+	thread->ready = true;
+
+	// inputs applied to the mirror but not yet presented
+	std::vector<uint32_t> pending_inputs;
+
+	bool running = true;
+	while(running) {
+		bool redraw = false;
+
+		render_command command;
+		while(thread->queue.pop(&command)) {
+			Minesweeper* board = context.board;
+
+			switch(command.type)
+			{
+				case RENDER_TILE:
+					board->tilemap[command.row][command.col] = command.tile;
+					board->changed_tiles.push_back({command.row, command.col});
+					break;
+
+				case RENDER_DEAD:
+					board->dead = true;
+					break;
+
+				case RENDER_NEW_GAME:
+					render_set_board(&context, new Minesweeper(command.width, command.height));
+					delete board;
+					break;
+
+				case RENDER_VIEW:
+					context.cam = command.cam;
+					context.show_minimap = command.show_minimap;
+					break;
+
+				case RENDER_FRAME:
+					if(command.input_ticks)
+						pending_inputs.push_back(command.input_ticks);
+					break;
+
+				case RENDER_QUIT:
+					running = false;
+					break;
+			}
+
+			redraw = true;
+		}
+
+		backend.output_size(&output_w, &output_h);
+		thread->output_w = output_w;
+		thread->output_h = output_h;
+
+		if(!redraw) {
+			SDL_Delay(1);
+			continue;
+		}
+
+		render_frame(&context);
+
+		for(uint32_t input_ticks : pending_inputs)
+			latency_record(&thread->latency, input_ticks);
+		pending_inputs.clear();
+	}
+
+	Minesweeper* board = context.board;
+	render_context_destroy(&context);
+	delete board;
+	SDL_DestroyRenderer(renderer);
+}
+
+bool render_thread_start(render_thread* thread, SDL_Window* window, TTF_Font* font, int board_width, int board_height)
+{
+	thread->thread = std::thread(render_thread_main, thread, window, font, board_width, board_height);
+
+	while(!thread->ready && !thread->failed)
+		SDL_Delay(1);
+
+	if(thread->failed) {
+		thread->thread.join();
+		return false;
+	}
+
+	return true;
+}
+
+void render_thread_push(render_thread* thread, const render_command& command)
+{
+	while(!thread->queue.push(command))
+		std::this_thread::yield();
+}
+
+void render_thread_stop(render_thread* thread)
+{
+	render_thread_push(thread, {.type = RENDER_QUIT});
+	thread->thread.join();
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <atomic>
+#include <thread>
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+
+#include "minesweeper.hpp"
+#include "camera.hpp"
+#include "board_renderer.hpp"
+#include "spsc_ring.hpp"
+
+// big enough for a large flood fill to be queued without the game thread waiting
+constexpr size_t RENDER_QUEUE_CAPACITY = 1 << 16;
+
+enum render_command_type : uint8_t
+{
+	RENDER_TILE,     // copy tile into the mirror board at (row, col)
+	RENDER_DEAD,     // the game was lost, reveal bombs
+	RENDER_NEW_GAME, // replace the mirror board with an empty one of (width, height)
+	RENDER_VIEW,     // new camera and minimap visibility
+	RENDER_FRAME,    // end of a game frame, input_ticks is the oldest input it handled
+	RENDER_QUIT,
+};
+
+struct render_command
+{
+	render_command_type type;
+	Tile tile = {};
+	int row = 0, col = 0;
+	int width = 0, height = 0;
+	uint32_t input_ticks = 0;
+	camera cam = {};
+	bool show_minimap = true;
+};
+
+// the render thread owns the SDL renderer and every texture, the game thread only talks to it through the queue
+struct render_thread
+{
+	std::thread thread;
+	SpscRing<render_command, RENDER_QUEUE_CAPACITY> queue;
+
+	// published by the render thread so the game thread can keep its camera viewport up to date
+	std::atomic<int> output_w = 0;
+	std::atomic<int> output_h = 0;
+
+	// set once the renderer exists, the output size alone can't tell since a minimized window reports 0x0
+	std::atomic<bool> ready = false;
+	std::atomic<bool> failed = false;
+
+	// only touched by the render thread until render_thread_stop returns
+	input_latency latency;
+};
+
+// creates the renderer for window on a new thread and blocks until it's ready, returns false on failure
+bool render_thread_start(render_thread* thread, SDL_Window* window, TTF_Font* font, int board_width, int board_height);
+
+// spins while the queue is full
+void render_thread_push(render_thread* thread, const render_command& command);
+
+// drains the queue, then destroys the renderer and joins the thread
+void render_thread_stop(render_thread* thread);
@@ -1,44 +1,153 @@
 #include <iostream>
 #include <filesystem>
+#include <algorithm>
 
 #include "renderer.hpp"
 #include "globals.hpp"
 
-void render_filled_rect(SDL_Renderer* renderer, const SDL_Rect* rect, uint8_t r, uint8_t g, uint8_t b, uint8_t a)
+void SdlRenderBackend::output_size(int* w, int* h)
 {
-    uint8_t o_r, o_g, o_b, o_a = 0; 
-    SDL_GetRenderDrawColor(renderer, &o_r, &o_g, &o_b, &o_a);
-    
-    SDL_SetRenderDrawColor(renderer, r, g, b, a);
+	SDL_GetRendererOutputSize(renderer, w, h);
+}
+
+int SdlRenderBackend::max_texture_size()
+{
+	SDL_RendererInfo info = {};
+	SDL_GetRendererInfo(renderer, &info);
+
+	// 0 means no limit
+	if(info.max_texture_width <= 0 || info.max_texture_height <= 0)
+		return INT32_MAX;
+
+	return std::min(info.max_texture_width, info.max_texture_height);
+}
+
+void SdlRenderBackend::clear()
+{
+	SDL_SetRenderDrawColor(renderer, clear_color.r, clear_color.g, clear_color.b, clear_color.a);
+	SDL_RenderClear(renderer);
+}
+
+void SdlRenderBackend::present()
+{
+	SDL_RenderPresent(renderer);
+}
+
+void SdlRenderBackend::fill_rect(const SDL_Rect* rect, SDL_Color color)
+{
+    SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
     SDL_RenderFillRect(renderer, rect);
-    SDL_SetRenderDrawColor(renderer, o_r, o_g, o_b, o_a);
 }
 
-void render_rect_with_color(SDL_Renderer* renderer, const SDL_Rect* rect, uint8_t r, uint8_t g, uint8_t b, uint8_t a)
+void SdlRenderBackend::outline_rect(const SDL_Rect* rect, SDL_Color color)
 {
-    uint8_t o_r, o_g, o_b, o_a = 0; 
-    SDL_GetRenderDrawColor(renderer, &o_r, &o_g, &o_b, &o_a);
-    
-    SDL_SetRenderDrawColor(renderer, r, g, b, a);
+    SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
     SDL_RenderDrawRect(renderer, rect);
-    SDL_SetRenderDrawColor(renderer, o_r, o_g, o_b, o_a);
 }
 
-SDL_Texture* render_surface_to_texture(SDL_Renderer* renderer, SDL_Surface* surface)
+void SdlRenderBackend::copy(const render_texture& texture, const SDL_Rect* src, const SDL_Rect* dst)
+{
+	SDL_RenderCopy(renderer, texture.sdl, src, dst);
+}
+
+render_texture SdlRenderBackend::create_texture(SDL_Surface* surface)
 {
     SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
 
 	if(texture == NULL) {
-		std::cout << "Could create bomb texture, ERROR:" << SDL_GetError() << "\n";
+		std::cout << "Couldn't create texture, ERROR:" << SDL_GetError() << "\n";
+		free_and_quit();
+	}
+
+	const render_texture result = { .sdl = texture, .w = surface->w, .h = surface->h };
+	SDL_FreeSurface(surface);
+
+	return result;
+}
+
+render_texture SdlRenderBackend::create_streaming_texture(int w, int h)
+{
+	SDL_Texture* texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, w, h);
+
+	if(texture == NULL) {
+		std::cout << "Couldn't create streaming texture, ERROR: " << SDL_GetError() << "\n";
+		free_and_quit();
+	}
+	SDL_SetTextureScaleMode(texture, SDL_ScaleModeNearest);
+
+	return { .sdl = texture, .w = w, .h = h };
+}
+
+void SdlRenderBackend::update_texture(render_texture& texture, const SDL_Rect* rect, const void* pixels, int pitch)
+{
+	if(SDL_UpdateTexture(texture.sdl, rect, pixels, pitch) < 0)
+		std::cout << "Couldn't update texture, ERROR: " << SDL_GetError() << "\n";
+}
+
+void SdlRenderBackend::destroy_texture(render_texture& texture)
+{
+	SDL_DestroyTexture(texture.sdl);
+	texture = {};
+}
+
+SoftwareRenderBackend::SoftwareRenderBackend(int w, int h) : SdlRenderBackend(nullptr)
+{
+	surface = SDL_CreateRGBSurfaceWithFormat(0, w, h, 32, SDL_PIXELFORMAT_ARGB8888);
+	if(surface == NULL) {
+		std::cout << "Couldn't create offscreen surface, ERROR: " << SDL_GetError() << "\n";
 		free_and_quit();
 	}
 
+	renderer = SDL_CreateSoftwareRenderer(surface);
+	if(renderer == NULL) {
+		std::cout << "Couldn't create software renderer, ERROR: " << SDL_GetError() << "\n";
+		free_and_quit();
+	}
+}
+
+SoftwareRenderBackend::~SoftwareRenderBackend()
+{
+	SDL_DestroyRenderer(renderer);
+	SDL_FreeSurface(surface);
+}
+
+render_texture NullRenderBackend::create_texture(SDL_Surface* surface)
+{
+	stats.textures_created++;
+
+	const render_texture result = { .sdl = nullptr, .w = surface->w, .h = surface->h };
 	SDL_FreeSurface(surface);
 
-	return texture;
+	return result;
+}
+
+render_texture NullRenderBackend::create_streaming_texture(int w, int h)
+{
+	stats.textures_created++;
+
+	return { .sdl = nullptr, .w = w, .h = h };
+}
+
+void NullRenderBackend::update_texture(render_texture& texture, const SDL_Rect* rect, const void*, int)
+{
+	const int w = rect ? rect->w : texture.w;
+	const int h = rect ? rect->h : texture.h;
+
+	stats.texture_uploads++;
+	stats.uploaded_bytes += (uint64_t)w * h * sizeof(uint32_t);
+}
+
+void render_filled_rect(RenderBackend* backend, const SDL_Rect* rect, uint8_t r, uint8_t g, uint8_t b, uint8_t a)
+{
+	backend->fill_rect(rect, {r, g, b, a});
+}
+
+void render_rect_with_color(RenderBackend* backend, const SDL_Rect* rect, uint8_t r, uint8_t g, uint8_t b, uint8_t a)
+{
+	backend->outline_rect(rect, {r, g, b, a});
 }
 
-SDL_Texture* load_and_render_image_to_texture(SDL_Renderer* renderer, const char* path)
+render_texture load_and_render_image_to_texture(RenderBackend* backend, const char* path)
 {
 	std::string cwd = std::filesystem::current_path().generic_string();
 	SDL_Surface* image_surface = IMG_Load(cwd.append("/").append(path).c_str());
@@ -48,10 +157,10 @@ SDL_Texture* load_and_render_image_to_texture(SDL_Renderer* renderer, const char
 		free_and_quit();
 	}
 
-	return render_surface_to_texture(renderer, image_surface);
+	return backend->create_texture(image_surface);
 }
 
-SDL_Texture* render_colored_text(SDL_Renderer* renderer, TTF_Font* font, const char* text, SDL_Color color)
+render_texture render_colored_text(RenderBackend* backend, TTF_Font* font, const char* text, SDL_Color color)
 {
 	SDL_Surface* text_surface = TTF_RenderText_Blended(font, text, color);
 
@@ -60,5 +169,32 @@ SDL_Texture* render_colored_text(SDL_Renderer* renderer, TTF_Font* font, const c
 		free_and_quit();
 	}
 
-	return render_surface_to_texture(renderer, text_surface);
+	return backend->create_texture(text_surface);
+}
+
+int count_differing_pixels(SDL_Surface* a, SDL_Surface* b)
+{
+	if(a->w != b->w || a->h != b->h)
+		return -1;
+
+	SDL_Surface* converted_a = SDL_ConvertSurfaceFormat(a, SDL_PIXELFORMAT_ARGB8888, 0);
+	SDL_Surface* converted_b = SDL_ConvertSurfaceFormat(b, SDL_PIXELFORMAT_ARGB8888, 0);
+	if(converted_a == NULL || converted_b == NULL) {
+		SDL_FreeSurface(converted_a);
+		SDL_FreeSurface(converted_b);
+		return -1;
+	}
+
+	int differing = 0;
+	for(int y = 0; y < a->h; y++) {
+		const uint32_t* row_a = (const uint32_t*)((const uint8_t*)converted_a->pixels + y * converted_a->pitch);
+		const uint32_t* row_b = (const uint32_t*)((const uint8_t*)converted_b->pixels + y * converted_b->pitch);
+		for(int x = 0; x < a->w; x++)
+			differing += row_a[x] != row_b[x];
+	}
+
+	SDL_FreeSurface(converted_a);
+	SDL_FreeSurface(converted_b);
+
+	return differing;
 }
@@ -3,9 +3,107 @@
 #include <SDL2/SDL_image.h>
 #include <SDL2/SDL_ttf.h>
 
-void render_filled_rect(SDL_Renderer* renderer, const SDL_Rect* rect, uint8_t r, uint8_t g, uint8_t b, uint8_t a = SDL_ALPHA_OPAQUE);
-void render_rect_with_color(SDL_Renderer* renderer, const SDL_Rect* rect, uint8_t r, uint8_t g, uint8_t b, uint8_t a = SDL_ALPHA_OPAQUE);
+// texture owned by a backend, the null backend only tracks the size
+struct render_texture
+{
+	SDL_Texture* sdl = nullptr;
+	int w = 0, h = 0;
+};
 
-SDL_Texture* render_surface_to_texture(SDL_Renderer* renderer, SDL_Surface* surface);
-SDL_Texture* load_and_render_image_to_texture(SDL_Renderer* renderer, const char* path);
-SDL_Texture* render_colored_text(SDL_Renderer* renderer, TTF_Font* font, const char* text, SDL_Color color = {0,0,0,0});
+// everything that draws goes through a backend so frames can be rendered without a window or gpu
+class RenderBackend {
+public:
+	virtual ~RenderBackend() = default;
+
+	virtual void output_size(int* w, int* h) = 0;
+	virtual int max_texture_size() = 0;
+
+	virtual void clear() = 0;
+	virtual void present() = 0;
+
+	virtual void fill_rect(const SDL_Rect* rect, SDL_Color color) = 0;
+	virtual void outline_rect(const SDL_Rect* rect, SDL_Color color) = 0;
+	virtual void copy(const render_texture& texture, const SDL_Rect* src, const SDL_Rect* dst) = 0;
+
+	// takes ownership of the surface
+	virtual render_texture create_texture(SDL_Surface* surface) = 0;
+	// ARGB8888 texture that is filled with update_texture, scaled with nearest filtering
+	virtual render_texture create_streaming_texture(int w, int h) = 0;
+	virtual void update_texture(render_texture& texture, const SDL_Rect* rect, const void* pixels, int pitch) = 0;
+	virtual void destroy_texture(render_texture& texture) = 0;
+};
+
+// draws with an existing SDL renderer, usually the window's accelerated one
+class SdlRenderBackend : public RenderBackend {
+protected:
+	SDL_Renderer* renderer;
+public:
+	SDL_Color clear_color = {255, 255, 255, SDL_ALPHA_OPAQUE};
+
+	SdlRenderBackend(SDL_Renderer* renderer) : renderer(renderer) {}
+
+	void output_size(int* w, int* h) override;
+	int max_texture_size() override;
+
+	void clear() override;
+	void present() override;
+
+	void fill_rect(const SDL_Rect* rect, SDL_Color color) override;
+	void outline_rect(const SDL_Rect* rect, SDL_Color color) override;
+	void copy(const render_texture& texture, const SDL_Rect* src, const SDL_Rect* dst) override;
+
+	render_texture create_texture(SDL_Surface* surface) override;
+	render_texture create_streaming_texture(int w, int h) override;
+	void update_texture(render_texture& texture, const SDL_Rect* rect, const void* pixels, int pitch) override;
+	void destroy_texture(render_texture& texture) override;
+};
+
+// SDL's software renderer drawing into an offscreen surface, frames can be saved or compared pixel by pixel
+class SoftwareRenderBackend : public SdlRenderBackend {
+public:
+	SDL_Surface* surface;
+
+	SoftwareRenderBackend(int w, int h);
+	~SoftwareRenderBackend() override;
+};
+
+// counters for the work submitted to the null backend
+struct render_stats
+{
+	uint64_t frames;
+	uint64_t fills, outlines, copies;
+	uint64_t textures_created, texture_uploads, uploaded_bytes;
+};
+
+// draws nothing and only counts work, for measuring everything but the rasterization
+class NullRenderBackend : public RenderBackend {
+	int w, h;
+public:
+	render_stats stats = {};
+
+	NullRenderBackend(int w, int h) : w(w), h(h) {}
+
+	void output_size(int* out_w, int* out_h) override { *out_w = w; *out_h = h; }
+	int max_texture_size() override { return 16384; }
+
+	void clear() override {}
+	void present() override { stats.frames++; }
+
+	void fill_rect(const SDL_Rect*, SDL_Color) override { stats.fills++; }
+	void outline_rect(const SDL_Rect*, SDL_Color) override { stats.outlines++; }
+	void copy(const render_texture&, const SDL_Rect*, const SDL_Rect*) override { stats.copies++; }
+
+	render_texture create_texture(SDL_Surface* surface) override;
+	render_texture create_streaming_texture(int w, int h) override;
+	void update_texture(render_texture& texture, const SDL_Rect* rect, const void* pixels, int pitch) override;
+	void destroy_texture(render_texture& texture) override { texture = {}; }
+};
+
+void render_filled_rect(RenderBackend* backend, const SDL_Rect* rect, uint8_t r, uint8_t g, uint8_t b, uint8_t a = SDL_ALPHA_OPAQUE);
+void render_rect_with_color(RenderBackend* backend, const SDL_Rect* rect, uint8_t r, uint8_t g, uint8_t b, uint8_t a = SDL_ALPHA_OPAQUE);
+
+render_texture load_and_render_image_to_texture(RenderBackend* backend, const char* path);
+render_texture render_colored_text(RenderBackend* backend, TTF_Font* font, const char* text, SDL_Color color = {0,0,0,0});
+
+// number of pixels that differ between two surfaces of the same size, -1 if the sizes differ
+int count_differing_pixels(SDL_Surface* a, SDL_Surface* b);
@@ -0,0 +1,278 @@
+#include <iostream>
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#include "replay.hpp"
+
+static void write_keyframe(replay_recorder* recorder, const Minesweeper* game, uint32_t time_ms)
+{
+	save_pack(game, recorder->game, &recorder->keyframe_buffer);
+	const uint64_t size = recorder->keyframe_buffer.size() * sizeof(uint64_t);
+
+	if(fwrite(recorder->keyframe_buffer.data(), 1, size, recorder->file) != size) {
+		std::cout << "Couldn't write a keyframe to " << recorder->path << "\n";
+		return;
+	}
+
+	recorder->keyframes.push_back({
+		.time_ms = time_ms,
+		.game = recorder->game,
+		.event_index = recorder->events.size(),
+		.offset = recorder->offset,
+		.size = size
+	});
+
+	recorder->offset += size;
+	recorder->moves_since_keyframe = 0;
+	recorder->tiles_since_keyframe = 0;
+}
+
+bool replay_record_start(replay_recorder* recorder, const char* path, const Minesweeper* game, uint32_t time_ms)
+{
+	if(game->height > JOURNAL_MAX_HEIGHT) {
+		std::cout << "Boards over " << JOURNAL_MAX_HEIGHT << " rows can't be recorded\n";
+		return false;
+	}
+
+	recorder->path = path;
+	recorder->file = fopen(path, "wb");
+	if(!recorder->file) {
+		std::cout << "Couldn't create " << path << "\n";
+		return false;
+	}
+
+	// filled in for real by replay_record_finish
+	replay_header& header = recorder->header;
+	std::memcpy(header.magic, REPLAY_MAGIC, sizeof(header.magic));
+	header.version = REPLAY_VERSION;
+	header.seed = game->seed;
+	header.width = game->width;
+	header.height = game->height;
+	header.bombcount = game->bomb_count();
+	recorder->start_ms = time_ms;
+
+	fwrite(&header, sizeof(header), 1, recorder->file);
+	recorder->offset = sizeof(header);
+
+	write_keyframe(recorder, game, 0);
+	return true;
+}
+
+void replay_record_move(replay_recorder* recorder, journal_action action, int row, int col, uint32_t time_ms)
+{
+	recorder->events.push_back({
+		.time_ms = time_ms - recorder->start_ms,
+		.move = { .action_row = ((uint32_t)action << JOURNAL_ROW_BITS) | (uint32_t)row, .col = (uint32_t)col }
+	});
+	recorder->moves_since_keyframe++;
+}
+
+void replay_record_update(replay_recorder* recorder, const Minesweeper* game, uint32_t time_ms)
+{
+	recorder->tiles_since_keyframe += game->changed_tiles.size();
+
+	// a keyframe in the middle of a reveal would miss tiles the recorded move still opens
+	const bool enough = recorder->moves_since_keyframe >= REPLAY_KEYFRAME_MOVES || recorder->tiles_since_keyframe >= REPLAY_KEYFRAME_TILES;
+	if(enough && !game->revealing())
+		write_keyframe(recorder, game, time_ms - recorder->start_ms);
+}
+
+void replay_record_game_over(replay_recorder* recorder, const Minesweeper* game, uint32_t time_ms)
+{
+	if(recorder->moves_since_keyframe > 0 && !game->revealing())
+		write_keyframe(recorder, game, time_ms - recorder->start_ms);
+}
+
+void replay_record_new_game(replay_recorder* recorder, const Minesweeper* game, uint32_t time_ms)
+{
+	recorder->game++;
+	write_keyframe(recorder, game, time_ms - recorder->start_ms);
+}
+
+bool replay_record_finish(replay_recorder* recorder, const Minesweeper* game, uint32_t time_ms)
+{
+	replay_record_game_over(recorder, game, time_ms);
+
+	replay_header& header = recorder->header;
+
+	header.duration_ms = time_ms - recorder->start_ms;
+	header.event_count = recorder->events.size();
+	header.events_offset = recorder->offset;
+	header.keyframe_count = recorder->keyframes.size();
+	header.keyframes_offset = header.events_offset + header.event_count * sizeof(replay_event);
+
+	const bool written = fwrite(recorder->events.data(), sizeof(replay_event), recorder->events.size(), recorder->file) == recorder->events.size() &&
+		fwrite(recorder->keyframes.data(), sizeof(replay_keyframe), recorder->keyframes.size(), recorder->file) == recorder->keyframes.size() &&
+		fseek(recorder->file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, recorder->file) == 1;
+
+	if(fclose(recorder->file) != 0 || !written) {
+		std::cout << "Couldn't write " << recorder->path << "\n";
+		recorder->file = nullptr;
+		return false;
+	}
+
+	recorder->file = nullptr;
+	return true;
+}
+
+bool replay_open(replay_player* player, const char* path)
+{
+	if(!map_file(&player->file, path)) {
+		std::cout << "Couldn't open " << path << "\n";
+		return false;
+	}
+
+	const uint8_t* data = (const uint8_t*)player->file.data;
+	const size_t size = player->file.size;
+	const replay_header* header = (const replay_header*)data;
+
+	// the counts are bounded by what's left of the file before multiplying, so a crafted header can't wrap around
+	const bool valid = size >= sizeof(replay_header) &&
+		std::memcmp(header->magic, REPLAY_MAGIC, sizeof(REPLAY_MAGIC)) == 0 && header->version == REPLAY_VERSION &&
+		header->keyframe_count > 0 && header->events_offset >= sizeof(replay_header) && header->events_offset <= size &&
+		header->event_count <= (size - header->events_offset) / sizeof(replay_event) &&
+		header->keyframes_offset == header->events_offset + header->event_count * sizeof(replay_event) &&
+		header->keyframe_count <= (size - header->keyframes_offset) / sizeof(replay_keyframe) &&
+		header->keyframes_offset + header->keyframe_count * sizeof(replay_keyframe) == size;
+
+	if(!valid) {
+		std::cout << path << " is not a finished replay this version can read\n";
+		replay_close(player);
+		return false;
+	}
+
+	player->header = header;
+	player->events = (const replay_event*)(data + header->events_offset);
+	player->keyframes = (const replay_keyframe*)(data + header->keyframes_offset);
+
+	for(uint64_t i = 0; i < header->keyframe_count; i++) {
+		const replay_keyframe& keyframe = player->keyframes[i];
+		// saves are whole uint64_ts and their planes are read in place, so keyframes stay 8 byte aligned
+		const bool inside = keyframe.size <= header->events_offset && keyframe.offset <= header->events_offset - keyframe.size &&
+			keyframe.offset >= sizeof(replay_header) && keyframe.offset % alignof(uint64_t) == 0;
+		if(!inside || keyframe.event_index > header->event_count) {
+			std::cout << path << " has a broken keyframe index\n";
+			replay_close(player);
+			return false;
+		}
+	}
+
+	player->board = nullptr;
+	return true;
+}
+
+void replay_close(replay_player* player)
+{
+	delete player->board;
+	unmap_file(&player->file);
+	*player = replay_player();
+}
+
+static void apply_event(replay_player* player, const replay_event& event)
+{
+	Minesweeper* board = player->board;
+	const journal_action action = (journal_action)(event.move.action_row >> JOURNAL_ROW_BITS);
+	const int row = (int)(event.move.action_row & ((1u << JOURNAL_ROW_BITS) - 1));
+	const int col = (int)event.move.col;
+
+	if(row < 1 || col < 1 || row > board->height || col > board->width)
+		return;
+
+	const size_t first_change = board->changed_tiles.size();
+
+	// the recorded game finished any opening in progress before each move too, so opening
+	// everything at once here lands on the boards the player had, keyframes included
+	if(action == JOURNAL_OPEN)
+		board->open_tile(row, col);
+	else if(action == JOURNAL_FLAG)
+		board->flag_tile(row, col);
+
+	// changed_tiles is left for the renderer, the planes only follow it
+	for(size_t i = first_change; i < board->changed_tiles.size(); i++) {
+		const auto [tile_row, tile_col] = board->changed_tiles[i];
+		const Tile& tile = board->tilemap[tile_row][tile_col];
+		const uint64_t bit = (uint64_t)(tile_row - 1) * board->width + (tile_col - 1);
+		const uint64_t mask = 1ull << (bit % 64);
+
+		player->open_plane[bit / 64] = tile.open    ? player->open_plane[bit / 64] | mask : player->open_plane[bit / 64] & ~mask;
+		player->flag_plane[bit / 64] = tile.flagged ? player->flag_plane[bit / 64] | mask : player->flag_plane[bit / 64] & ~mask;
+	}
+}
+
+// returns true if the board object was replaced
+static bool restore_keyframe(replay_player* player, const replay_keyframe& keyframe)
+{
+	save_view view;
+	if(!save_parse(&view, (const uint8_t*)player->file.data + keyframe.offset, keyframe.size, false, "replay keyframe"))
+		return false;
+
+	Minesweeper* board = player->board;
+	const bool same_board = board && player->game == keyframe.game &&
+		board->width == (int)view.header->width && board->height == (int)view.header->height;
+
+	player->next_event = keyframe.event_index;
+	player->game = keyframe.game;
+
+	if(!same_board) {
+		delete player->board;
+		player->board = save_load_game(view);
+		player->open_plane.assign(view.open, view.open + view.header->plane_words);
+		player->flag_plane.assign(view.flagged, view.flagged + view.header->plane_words);
+		return true;
+	}
+
+	// the mines are the same, only the tiles whose open or flag bit differs are touched
+	for(uint64_t word = 0; word < view.header->plane_words; word++) {
+		uint64_t differ = (player->open_plane[word] ^ view.open[word]) | (player->flag_plane[word] ^ view.flagged[word]);
+		while(differ) {
+			const uint64_t bit = word * 64 + std::countr_zero(differ);
+			differ &= differ - 1;
+
+			const int row = (int)(bit / board->width) + 1;
+			const int col = (int)(bit % board->width) + 1;
+			Tile& tile = board->tilemap[row][col];
+			tile.open = (view.open[word] >> (bit % 64)) & 1;
+			tile.flagged = (view.flagged[word] >> (bit % 64)) & 1;
+			board->changed_tiles.push_back({row, col});
+			board->refresh_view(row, col);
+		}
+
+		player->open_plane[word] = view.open[word];
+		player->flag_plane[word] = view.flagged[word];
+	}
+
+	board->dead = (view.header->flags & SAVE_FLAG_DEAD) != 0;
+	return false;
+}
+
+bool replay_seek(replay_player* player, uint32_t time_ms)
+{
+	const replay_header* header = player->header;
+
+	// the last keyframe at or before time_ms, the first one always starts the replay
+	const replay_keyframe* keyframes_end = player->keyframes + header->keyframe_count;
+	const replay_keyframe* keyframe = std::upper_bound(player->keyframes, keyframes_end, time_ms,
+		[](uint32_t time, const replay_keyframe& frame) { return time < frame.time_ms; });
+	if(keyframe != player->keyframes)
+		keyframe--;
+
+	// playing forward from where the board is is cheaper, unless a keyframe in between skips more
+	bool replaced = false;
+	const bool forward = player->board && time_ms >= player->time_ms && player->next_event >= keyframe->event_index &&
+		player->game == keyframe->game;
+	if(!forward)
+		replaced = restore_keyframe(player, *keyframe);
+
+	// events at exactly time_ms are included
+	const replay_event* events_end = player->events + header->event_count;
+	const replay_event* last = std::upper_bound(player->events + player->next_event, events_end, time_ms,
+		[](uint32_t time, const replay_event& event) { return time < event.time_ms; });
+
+	for(const replay_event* event = player->events + player->next_event; event < last; event++)
+		apply_event(player, *event);
+
+	player->next_event = last - player->events;
+	player->time_ms = time_ms;
+	return replaced;
+}
@@ -0,0 +1,109 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "minesweeper.hpp"
+#include "journal.hpp"
+#include "save.hpp"
+
+constexpr char REPLAY_MAGIC[4] = { 'M', 'S', 'W', 'R' };
+constexpr uint32_t REPLAY_VERSION = 1;
+
+// a keyframe is written after this many moves or changed tiles, whichever comes first
+// so a seek never replays more than that on top of the keyframe it starts from
+constexpr uint32_t REPLAY_KEYFRAME_MOVES = 256;
+constexpr uint64_t REPLAY_KEYFRAME_TILES = 1 << 16;
+
+// the keyframes follow the header, the events and keyframe index are written at the end
+struct replay_header
+{
+	char magic[4];
+	uint32_t version;
+	uint64_t seed; // of the first game, every keyframe carries its own
+	uint32_t width, height;
+	uint32_t bombcount;
+	uint32_t duration_ms;
+	uint64_t event_count;
+	uint64_t events_offset;
+	uint64_t keyframe_count;
+	uint64_t keyframes_offset;
+};
+
+// a move, encoded like the journal's, in the order the game applied them
+struct replay_event
+{
+	uint32_t time_ms;
+	journal_record move;
+};
+
+struct replay_keyframe
+{
+	uint32_t time_ms;
+	uint32_t game;        // counts new games, a keyframe from another game can't be patched onto the board
+	uint64_t event_index; // events before this are already part of the keyframe
+	uint64_t offset;      // of a complete save in the file
+	uint64_t size;
+};
+
+// keyframes stream to the file while playing, the events stay in memory until replay_record_finish
+struct replay_recorder
+{
+	FILE* file = nullptr;
+	std::string path;
+	uint64_t offset = 0;
+
+	std::vector<replay_event> events;
+	std::vector<replay_keyframe> keyframes;
+	std::vector<uint64_t> keyframe_buffer;
+
+	uint32_t start_ms = 0;
+	uint32_t game = 0;
+	uint32_t moves_since_keyframe = 0;
+	uint64_t tiles_since_keyframe = 0;
+	replay_header header = {};
+};
+
+// time_ms is on the caller's clock, it only has to keep counting up
+bool replay_record_start(replay_recorder* recorder, const char* path, const Minesweeper* game, uint32_t time_ms);
+void replay_record_move(replay_recorder* recorder, journal_action action, int row, int col, uint32_t time_ms);
+
+// call every frame before changed_tiles is cleared, writes a keyframe once enough changed
+void replay_record_update(replay_recorder* recorder, const Minesweeper* game, uint32_t time_ms);
+
+// keyframes a board that's about to be replaced, so the last moves of every game can be checked too
+// skipped mid reveal, the keyframe would miss tiles the recorded moves still open
+void replay_record_game_over(replay_recorder* recorder, const Minesweeper* game, uint32_t time_ms);
+
+// the board was replaced, keyframes it right away
+void replay_record_new_game(replay_recorder* recorder, const Minesweeper* game, uint32_t time_ms);
+
+// game is the board being played, it gets a closing keyframe like replay_record_game_over
+bool replay_record_finish(replay_recorder* recorder, const Minesweeper* game, uint32_t time_ms);
+
+// plays a mapped replay file back onto its own board
+struct replay_player
+{
+	mapped_file file;
+	const replay_header* header = nullptr;
+	const replay_event* events = nullptr;
+	const replay_keyframe* keyframes = nullptr;
+
+	Minesweeper* board = nullptr;
+	uint32_t game = 0;
+	uint64_t next_event = 0;
+	uint32_t time_ms = 0;
+
+	// open and flag state of board, so restoring a keyframe only touches tiles that differ
+	std::vector<uint64_t> open_plane;
+	std::vector<uint64_t> flag_plane;
+};
+
+bool replay_open(replay_player* player, const char* path);
+void replay_close(replay_player* player);
+
+// puts the board in the state it had at time_ms: binary searches the last keyframe before it and
+// replays the moves after, or just plays forward when that's closer
+// returns true if player->board was replaced by a new object, renderers have to pick it up
+bool replay_seek(replay_player* player, uint32_t time_ms);
@@ -0,0 +1,514 @@
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+
+#include "replay_analysis.hpp"
+#include "replay.hpp"
+
+constexpr const char* REPLAY_EXTENSION = ".msr";
+
+// big enough that one opening takes several reveal slices
+constexpr int SELF_CHECK_SIZE = 300;
+constexpr int SELF_CHECK_BOMBCOUNT = 300;
+constexpr uint32_t SELF_CHECK_FRAME_MS = 16;
+
+// running totals are printed this often, a short run only prints the final ones
+constexpr auto ANALYSIS_PROGRESS_INTERVAL = std::chrono::seconds(1);
+constexpr auto ANALYSIS_POLL_INTERVAL = std::chrono::milliseconds(50);
+
+// over every game of the replays that checked out
+struct analysis_totals
+{
+	uint64_t replays = 0;
+	uint64_t invalid = 0;
+	uint64_t games = 0;
+	uint64_t won = 0;
+	uint64_t lost = 0;
+	uint64_t clicks = 0;
+	uint64_t bbbv_solved = 0;
+	uint64_t active_ms = 0; // first to last move of each game
+
+	// averaged over games with at least one click
+	double efficiency_sum = 0;
+	uint64_t efficiency_games = 0;
+
+	double best_bbbv_per_second = 0; // won games only
+};
+
+// scratch space a worker keeps between replays so small boards don't allocate every time
+struct analysis_worker
+{
+	std::vector<uint64_t> open_plane;
+	std::vector<uint64_t> flag_plane;
+	std::vector<uint8_t> visited;
+	std::vector<std::pair<int, int>> stack;
+};
+
+// moves of the game being simulated
+struct game_moves
+{
+	uint64_t clicks = 0;
+	uint32_t first_ms = 0;
+	uint32_t last_ms = 0;
+};
+
+// 3bv is the fewest clicks that clear the board, one per opening plus one per number not on the edge of one
+// solved counts the ones already cleared, an opening counts once any of it is open
+static void count_3bv(const Minesweeper* board, analysis_worker* worker, uint64_t* total, uint64_t* solved)
+{
+	const int width = board->width, height = board->height;
+	std::vector<uint8_t>& visited = worker->visited;
+	std::vector<std::pair<int, int>>& stack = worker->stack;
+	visited.assign((size_t)(width + 2) * (height + 2), 0);
+
+	*total = 0;
+	*solved = 0;
+
+	// openings, the numbers around one are marked so they aren't counted again below
+	for(int row = 1; row <= height; row++) {
+		for(int col = 1; col <= width; col++) {
+			if(visited[(size_t)row * (width + 2) + col] || board->tilemap[row][col].data != TILE_EMPTY)
+				continue;
+
+			bool opened = false;
+			visited[(size_t)row * (width + 2) + col] = 1;
+			stack.push_back({row, col});
+
+			while(!stack.empty()) {
+				const auto [tile_row, tile_col] = stack.back();
+				stack.pop_back();
+				opened |= board->tilemap[tile_row][tile_col].open;
+
+				for(int i = -1; i <= 1; i++) {
+					for(int j = -1; j <= 1; j++) {
+						const int r = tile_row + i, c = tile_col + j;
+						if(r < 1 || c < 1 || r > height || c > width || visited[(size_t)r * (width + 2) + c])
+							continue;
+
+						visited[(size_t)r * (width + 2) + c] = 1;
+						opened |= board->tilemap[r][c].open;
+						if(board->tilemap[r][c].data == TILE_EMPTY)
+							stack.push_back({r, c});
+					}
+				}
+			}
+
+			(*total)++;
+			*solved += opened;
+		}
+	}
+
+	for(int row = 1; row <= height; row++) {
+		for(int col = 1; col <= width; col++) {
+			const Tile& tile = board->tilemap[row][col];
+			if(visited[(size_t)row * (width + 2) + col] || tile.data == TILE_BOMB)
+				continue;
+
+			(*total)++;
+			*solved += tile.open;
+		}
+	}
+}
+
+static void finish_game(const Minesweeper* board, const game_moves& moves, analysis_worker* worker, analysis_totals* totals)
+{
+	uint64_t bbbv = 0, bbbv_solved = 0;
+	count_3bv(board, worker, &bbbv, &bbbv_solved);
+
+	uint64_t open_tiles = 0;
+	for(uint64_t word : worker->open_plane)
+		open_tiles += std::popcount(word);
+
+	const bool won = !board->dead && open_tiles == (uint64_t)board->width * board->height - board->bomb_count();
+	const uint32_t active_ms = moves.last_ms - moves.first_ms;
+
+	totals->games++;
+	totals->won += won;
+	totals->lost += board->dead;
+	totals->clicks += moves.clicks;
+	totals->bbbv_solved += bbbv_solved;
+	totals->active_ms += active_ms;
+
+	if(moves.clicks > 0) {
+		totals->efficiency_sum += (double)bbbv_solved / moves.clicks;
+		totals->efficiency_games++;
+	}
+
+	if(won && active_ms > 0)
+		totals->best_bbbv_per_second = std::max(totals->best_bbbv_per_second, bbbv * 1000.0 / active_ms);
+}
+
+// keeps the worker's planes in step with the board, like replay_player does
+static void track_changes(Minesweeper* board, analysis_worker* worker)
+{
+	for(const auto& [row, col] : board->changed_tiles) {
+		const Tile& tile = board->tilemap[row][col];
+		const uint64_t bit = (uint64_t)(row - 1) * board->width + (col - 1);
+		const uint64_t mask = 1ull << (bit % 64);
+
+		worker->open_plane[bit / 64] = tile.open    ? worker->open_plane[bit / 64] | mask : worker->open_plane[bit / 64] & ~mask;
+		worker->flag_plane[bit / 64] = tile.flagged ? worker->flag_plane[bit / 64] | mask : worker->flag_plane[bit / 64] & ~mask;
+	}
+
+	board->changed_tiles.clear();
+}
+
+// a fresh board from the keyframe's seed, with whatever progress the keyframe already has
+// the caller only lets the first keyframe of a replay carry progress
+// returns nullptr if the keyframe's mines aren't the ones the seed places
+static Minesweeper* start_game(const save_view& view, analysis_worker* worker)
+{
+	const save_header* save = view.header;
+	Minesweeper* board = new Minesweeper((int)save->width, (int)save->height, (int)save->bombcount, save->seed);
+
+	for(int row = 1; row <= board->height; row++) {
+		for(int col = 1; col <= board->width; col++) {
+			Tile& tile = board->tilemap[row][col];
+			if((tile.data == TILE_BOMB) != save_bit(view, view.mines, row, col)) {
+				delete board;
+				return nullptr;
+			}
+
+			// a recording can start from a loaded game
+			tile.open = save_bit(view, view.open, row, col);
+			tile.flagged = save_bit(view, view.flagged, row, col);
+		}
+	}
+
+	board->dead = (save->flags & SAVE_FLAG_DEAD) != 0;
+	worker->open_plane.assign(view.open, view.open + save->plane_words);
+	worker->flag_plane.assign(view.flagged, view.flagged + save->plane_words);
+	return board;
+}
+
+// replays every move on a fresh board and checks each keyframe against it
+// returns why the replay doesn't add up, or nullptr with its games added to totals
+static const char* check_replay(const replay_player& player, const char* path, analysis_worker* worker, Minesweeper** board, analysis_totals* totals)
+{
+	const replay_header* header = player.header;
+	const uint8_t* data = (const uint8_t*)player.file.data;
+
+	game_moves moves;
+	uint32_t game = 0;
+	uint32_t last_time = 0;
+	uint64_t next_event = 0;
+
+	for(uint64_t i = 0; i <= header->keyframe_count; i++) {
+		// the moves up to the next keyframe, or to the end after the last one
+		const uint64_t events_end = i < header->keyframe_count ? player.keyframes[i].event_index : header->event_count;
+		if(events_end < next_event)
+			return "keyframes are out of order";
+
+		if(events_end > next_event && !*board)
+			return "moves come before the first keyframe";
+
+		for(; next_event < events_end; next_event++) {
+			const replay_event& event = player.events[next_event];
+			if(event.time_ms < last_time || event.time_ms > header->duration_ms)
+				return "timestamps go backwards";
+			last_time = event.time_ms;
+
+			const journal_action action = (journal_action)(event.move.action_row >> JOURNAL_ROW_BITS);
+			const int row = (int)(event.move.action_row & ((1u << JOURNAL_ROW_BITS) - 1));
+			const int col = (int)event.move.col;
+			if(action > JOURNAL_FLAG || row < 1 || col < 1 || row > (*board)->height || col > (*board)->width)
+				return "a move is outside the board";
+
+			if(moves.clicks == 0)
+				moves.first_ms = event.time_ms;
+			moves.last_ms = event.time_ms;
+			moves.clicks++;
+
+			if(action == JOURNAL_OPEN)
+				(*board)->open_tile(row, col);
+			else
+				(*board)->flag_tile(row, col);
+
+			track_changes(*board, worker);
+		}
+
+		if(i == header->keyframe_count)
+			break;
+
+		const replay_keyframe& keyframe = player.keyframes[i];
+		if(keyframe.time_ms < last_time)
+			return "timestamps go backwards";
+		last_time = keyframe.time_ms;
+
+		save_view view;
+		if(!save_parse(&view, data + keyframe.offset, keyframe.size, true, path))
+			return "a keyframe is corrupted";
+
+		if(i == 0 || keyframe.game != game) {
+			if(i == 0 && (view.header->seed != header->seed || view.header->width != header->width || view.header->height != header->height))
+				return "the first keyframe doesn't match the header";
+
+			if(i != 0 && keyframe.game != game + 1)
+				return "games are out of order";
+
+			// only the first game can start from a loaded board, later ones start untouched
+			const uint64_t words = view.header->plane_words;
+			if(i != 0 && ((view.header->flags & SAVE_FLAG_DEAD) ||
+				std::any_of(view.open, view.open + words, [](uint64_t word) { return word != 0; }) ||
+				std::any_of(view.flagged, view.flagged + words, [](uint64_t word) { return word != 0; })))
+			{
+				return "a new game starts with tiles already played";
+			}
+
+			if(*board)
+				finish_game(*board, moves, worker, totals);
+
+			delete *board;
+			*board = start_game(view, worker);
+			if(!*board)
+				return "the mines don't match the seed";
+
+			moves = game_moves();
+			game = keyframe.game;
+			continue;
+		}
+
+		// every other keyframe has to be exactly what the moves before it leave behind
+		const uint64_t words = view.header->plane_words;
+		const bool matches = words == worker->open_plane.size() &&
+			std::equal(view.open, view.open + words, worker->open_plane.begin()) &&
+			std::equal(view.flagged, view.flagged + words, worker->flag_plane.begin()) &&
+			(*board)->dead == ((view.header->flags & SAVE_FLAG_DEAD) != 0);
+
+		if(!matches)
+			return "the moves don't lead to the recorded board";
+	}
+
+	finish_game(*board, moves, worker, totals);
+	return nullptr;
+}
+
+static void print_totals(const analysis_totals& totals, size_t file_count, double seconds, int threads)
+{
+	const double active_seconds = totals.active_ms / 1000.0;
+	const uint64_t checked = totals.replays + totals.invalid;
+
+	printf("%llu/%zu replays in %.1f s (%.0f/s on %d threads), %llu invalid\n", (unsigned long long)checked, file_count, seconds,
+		seconds > 0 ? checked / seconds : 0.0, threads, (unsigned long long)totals.invalid);
+
+	printf("  %llu games, %llu won, %llu lost, %.2f clicks/s, %.2f 3bv/s, %.1f%% efficiency, best won game %.2f 3bv/s\n",
+		(unsigned long long)totals.games, (unsigned long long)totals.won, (unsigned long long)totals.lost,
+		active_seconds > 0 ? totals.clicks / active_seconds : 0.0,
+		active_seconds > 0 ? totals.bbbv_solved / active_seconds : 0.0,
+		totals.efficiency_games > 0 ? totals.efficiency_sum * 100.0 / totals.efficiency_games : 0.0,
+		totals.best_bbbv_per_second);
+
+	fflush(stdout);
+}
+
+static void merge_totals(analysis_totals* into, const analysis_totals& from)
+{
+	into->replays += from.replays;
+	into->invalid += from.invalid;
+	into->games += from.games;
+	into->won += from.won;
+	into->lost += from.lost;
+	into->clicks += from.clicks;
+	into->bbbv_solved += from.bbbv_solved;
+	into->active_ms += from.active_ms;
+	into->efficiency_sum += from.efficiency_sum;
+	into->efficiency_games += from.efficiency_games;
+	into->best_bbbv_per_second = std::max(into->best_bbbv_per_second, from.best_bbbv_per_second);
+}
+
+int run_replay_analysis(const std::vector<std::string>& paths, int threads)
+{
+	std::vector<std::string> files;
+	for(const std::string& path : paths) {
+		std::error_code error;
+		if(!std::filesystem::is_directory(path, error)) {
+			files.push_back(path);
+			continue;
+		}
+
+		for(const auto& entry : std::filesystem::recursive_directory_iterator(path, error))
+			if(entry.is_regular_file() && entry.path().extension() == REPLAY_EXTENSION)
+				files.push_back(entry.path().string());
+	}
+
+	if(files.empty()) {
+		std::cout << "No replays found\n";
+		return EXIT_FAILURE;
+	}
+
+	// directory order isn't stable, sorting keeps reruns over the same corpus comparable
+	std::sort(files.begin(), files.end());
+	threads = std::clamp(threads, 1, (int)std::min<size_t>(files.size(), 1024));
+
+	std::atomic<size_t> next_file = 0;
+	std::atomic<int> running = threads;
+	std::mutex totals_mutex;
+	analysis_totals totals;
+
+	// each worker takes the next file, a slow one doesn't hold up a whole share of the corpus
+	auto work = [&]() {
+		analysis_worker worker;
+		for(size_t i = next_file++; i < files.size(); i = next_file++) {
+			const char* path = files[i].c_str();
+			analysis_totals replay;
+			const char* problem = "can't be read";
+
+			replay_player player;
+			if(replay_open(&player, path)) {
+				Minesweeper* board = nullptr;
+				problem = check_replay(player, path, &worker, &board, &replay);
+				delete board;
+				replay_close(&player);
+			}
+
+			std::lock_guard<std::mutex> lock(totals_mutex);
+			if(problem) {
+				totals.invalid++;
+				std::cout << path << ": " << problem << "\n";
+			}
+			else {
+				replay.replays = 1;
+				merge_totals(&totals, replay);
+			}
+		}
+
+		running--;
+	};
+
+	const auto start = std::chrono::steady_clock::now();
+	std::vector<std::thread> pool;
+	for(int i = 0; i < threads; i++)
+		pool.emplace_back(work);
+
+	auto last_print = start;
+	while(running > 0) {
+		std::this_thread::sleep_for(ANALYSIS_POLL_INTERVAL);
+
+		const auto now = std::chrono::steady_clock::now();
+		if(now - last_print < ANALYSIS_PROGRESS_INTERVAL)
+			continue;
+
+		last_print = now;
+		std::lock_guard<std::mutex> lock(totals_mutex);
+		print_totals(totals, files.size(), std::chrono::duration<double>(now - start).count(), threads);
+	}
+
+	for(std::thread& thread : pool)
+		thread.join();
+
+	print_totals(totals, files.size(), std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(), threads);
+	return totals.invalid == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// plays one frame like the window does: a slice of the opening, then the recorder's per frame update
+static void self_check_frame(replay_recorder* recorder, Minesweeper* game, uint32_t* time_ms)
+{
+	*time_ms += SELF_CHECK_FRAME_MS;
+	game->reveal_step(std::chrono::steady_clock::now());
+	replay_record_update(recorder, game, *time_ms);
+	game->changed_tiles.clear();
+}
+
+// starts an opening and makes a move while it's still in progress, on a tile the opening hasn't reached
+// or on a mine, returns false if the board has no opening that takes more than one slice
+static bool self_check_game(replay_recorder* recorder, Minesweeper* game, bool open_mine, uint32_t* time_ms)
+{
+	Minesweeper finished(game->width, game->height, game->bomb_count(), game->seed);
+
+	int start_row = 0, start_col = 0;
+	for(int row = 1; row <= game->height && !start_row; row++) {
+		for(int col = 1; col <= game->width; col++) {
+			if(game->tilemap[row][col].data == TILE_EMPTY) {
+				start_row = row;
+				start_col = col;
+				break;
+			}
+		}
+	}
+
+	if(!start_row)
+		return false;
+	finished.open_tile(start_row, start_col);
+
+	replay_record_move(recorder, JOURNAL_OPEN, start_row, start_col, *time_ms);
+	game->queue_open(start_row, start_col);
+	self_check_frame(recorder, game, time_ms);
+	if(!game->revealing())
+		return false;
+
+	for(int row = 1; row <= game->height; row++) {
+		for(int col = 1; col <= game->width; col++) {
+			const Tile& tile = game->tilemap[row][col];
+			const bool target = open_mine ? tile.data == TILE_BOMB : !tile.open && finished.tilemap[row][col].open;
+			if(!target)
+				continue;
+
+			const journal_action action = open_mine ? JOURNAL_OPEN : JOURNAL_FLAG;
+			replay_record_move(recorder, action, row, col, *time_ms);
+			if(open_mine)
+				game->queue_open(row, col);
+			else
+				game->flag_tile(row, col);
+
+			while(game->revealing())
+				self_check_frame(recorder, game, time_ms);
+			self_check_frame(recorder, game, time_ms);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+int run_replay_self_check(const char* path)
+{
+	Minesweeper game(SELF_CHECK_SIZE, SELF_CHECK_SIZE, SELF_CHECK_BOMBCOUNT, 1);
+	replay_recorder recorder;
+	uint32_t time_ms = 0;
+	if(!replay_record_start(&recorder, path, &game, time_ms))
+		return EXIT_FAILURE;
+
+	// a flag on a tile the opening would reach, then a mine clicked before the opening is done
+	bool played = self_check_game(&recorder, &game, false, &time_ms);
+
+	replay_record_game_over(&recorder, &game, time_ms);
+	game.new_game(2);
+	game.changed_tiles.clear();
+	replay_record_new_game(&recorder, &game, time_ms);
+
+	played = self_check_game(&recorder, &game, true, &time_ms) && played;
+	if(!replay_record_finish(&recorder, &game, time_ms))
+		return EXIT_FAILURE;
+
+	if(!played) {
+		std::cout << "The self check boards have no opening big enough to move during\n";
+		return EXIT_FAILURE;
+	}
+
+	replay_player player;
+	if(!replay_open(&player, path))
+		return EXIT_FAILURE;
+
+	analysis_worker worker;
+	analysis_totals totals;
+	Minesweeper* board = nullptr;
+	const char* problem = check_replay(player, path, &worker, &board, &totals);
+	delete board;
+	replay_close(&player);
+
+	if(problem) {
+		std::cout << path << ": " << problem << "\n";
+		return EXIT_FAILURE;
+	}
+
+	printf("Moves made during openings replay to the recorded boards (%llu games)\n", (unsigned long long)totals.games);
+	std::remove(path);
+	return EXIT_SUCCESS;
+}
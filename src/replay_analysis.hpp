@@ -0,0 +1,12 @@
+#pragma once
+#include <string>
+#include <vector>
+
+// re-simulates every replay in paths (files, or directories searched for .msr files) against the engine
+// on worker threads, prints the replays that don't add up as they're found and running totals while it works
+// returns the process exit code, nonzero if any replay failed validation
+int run_replay_analysis(const std::vector<std::string>& paths, int threads);
+
+// records games at path with a flag and a mine clicked while an opening is still spread over frames
+// then validates the replay like run_replay_analysis, the moves have to replay to the recorded boards
+int run_replay_self_check(const char* path);
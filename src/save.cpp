@@ -0,0 +1,268 @@
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <bit>
+
+#ifdef _WIN32
+#include <io.h>
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "save.hpp"
+
+uint64_t save_checksum(const uint64_t* words, size_t count)
+{
+	// a word at a time, byte wise hashing would take longer than mapping the file
+	uint64_t hash = 0xcbf29ce484222325ull;
+	for(size_t i = 0; i < count; i++) {
+		hash = (hash ^ words[i]) * 0x100000001b3ull;
+		hash ^= hash >> 32;
+	}
+	return hash;
+}
+
+void save_pack(const Minesweeper* game, uint64_t generation, std::vector<uint64_t>* data)
+{
+	static_assert(sizeof(save_header) % sizeof(uint64_t) == 0, "planes have to stay 8 byte aligned");
+	constexpr size_t header_words = sizeof(save_header) / sizeof(uint64_t);
+
+	const uint64_t tiles = (uint64_t)game->width * game->height;
+	const uint64_t plane_words = (tiles + 63) / 64;
+
+	data->assign(header_words + plane_words * 3, 0);
+
+	// mines, open and flagged one after another
+	uint64_t* mines = data->data() + header_words;
+	uint64_t* open = mines + plane_words;
+	uint64_t* flagged = open + plane_words;
+
+	uint64_t bit = 0;
+	for(int row = 1; row <= game->height; row++) {
+		for(int col = 1; col <= game->width; col++, bit++) {
+			const Tile& tile = game->tilemap[row][col];
+			mines[bit / 64]   |= (uint64_t)(tile.data == TILE_BOMB) << (bit % 64);
+			open[bit / 64]    |= (uint64_t)tile.open << (bit % 64);
+			flagged[bit / 64] |= (uint64_t)tile.flagged << (bit % 64);
+		}
+	}
+
+	save_header* header = (save_header*)data->data();
+	std::memcpy(header->magic, SAVE_MAGIC, sizeof(header->magic));
+	header->version = SAVE_VERSION;
+	header->width = game->width;
+	header->height = game->height;
+	header->bombcount = game->bomb_count();
+	header->flags = game->dead ? SAVE_FLAG_DEAD : 0;
+	header->seed = game->seed;
+	header->generation = generation;
+	header->plane_words = plane_words;
+	header->checksum = save_checksum(mines, plane_words * 3);
+}
+
+bool save_write(const std::vector<uint64_t>& data, const char* path)
+{
+	const std::string temp_path = std::string(path) + ".tmp";
+	FILE* file = fopen(temp_path.c_str(), "wb");
+	if(!file) {
+		std::cout << "Couldn't create " << temp_path << "\n";
+		return false;
+	}
+
+	bool written = fwrite(data.data(), sizeof(uint64_t), data.size(), file) == data.size() && fflush(file) == 0;
+
+	// the data has to be on disk before the rename can make it the save
+#ifdef _WIN32
+	written = written && _commit(_fileno(file)) == 0;
+#else
+	written = written && fsync(fileno(file)) == 0;
+#endif
+
+	if(fclose(file) != 0 || !written) {
+		std::cout << "Couldn't write " << temp_path << "\n";
+		std::remove(temp_path.c_str());
+		return false;
+	}
+
+	// replacing in one step, rename doesn't overwrite on Windows but MoveFileEx does
+#ifdef _WIN32
+	if(!MoveFileExA(temp_path.c_str(), path, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+#else
+	if(std::rename(temp_path.c_str(), path) != 0) {
+#endif
+		std::cout << "Couldn't replace " << path << "\n";
+		return false;
+	}
+
+#ifndef _WIN32
+	// and the rename only survives a power loss once the directory entry is on disk too
+	const std::string name = path;
+	const size_t slash = name.find_last_of('/');
+	const std::string directory = slash == std::string::npos ? "." : slash == 0 ? "/" : name.substr(0, slash);
+
+	const int directory_fd = open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+	if(directory_fd < 0 || fsync(directory_fd) != 0) {
+		std::cout << "Couldn't sync " << directory << "\n";
+		if(directory_fd >= 0)
+			close(directory_fd);
+		return false;
+	}
+	close(directory_fd);
+#endif
+
+	return true;
+}
+
+bool save_game(const Minesweeper* game, const char* path)
+{
+	std::vector<uint64_t> data;
+	save_pack(game, 0, &data);
+	return save_write(data, path);
+}
+
+bool map_file(mapped_file* file, const char* path)
+{
+#ifdef _WIN32
+	FILE* handle = fopen(path, "rb");
+	if(!handle)
+		return false;
+
+	fseek(handle, 0, SEEK_END);
+	const long size = ftell(handle);
+	fseek(handle, 0, SEEK_SET);
+
+	file->buffer.assign((size + sizeof(uint64_t) - 1) / sizeof(uint64_t), 0);
+	const bool read = size > 0 && fread(file->buffer.data(), 1, size, handle) == (size_t)size;
+	fclose(handle);
+
+	file->data = file->buffer.data();
+	file->size = read ? size : 0;
+	return read;
+#else
+	const int fd = open(path, O_RDONLY);
+	if(fd < 0)
+		return false;
+
+	struct stat file_stat = {};
+	if(fstat(fd, &file_stat) < 0 || file_stat.st_size == 0) {
+		close(fd);
+		return false;
+	}
+
+	// the mapping keeps the file alive after the descriptor is closed
+	void* mapping = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if(mapping == MAP_FAILED)
+		return false;
+
+	file->data = mapping;
+	file->size = file_stat.st_size;
+	return true;
+#endif
+}
+
+void unmap_file(mapped_file* file)
+{
+#ifndef _WIN32
+	if(file->data)
+		munmap(file->data, file->size);
+#endif
+
+	*file = mapped_file();
+}
+
+bool save_parse(save_view* view, const void* data, size_t size, bool verify_checksum, const char* name)
+{
+	const save_header* header = (const save_header*)data;
+	const bool header_valid = size >= sizeof(save_header) &&
+		std::memcmp(header->magic, SAVE_MAGIC, sizeof(SAVE_MAGIC)) == 0 && header->version == SAVE_VERSION &&
+		header->width > 0 && header->height > 0 && header->width <= SAVE_MAX_SIDE && header->height <= SAVE_MAX_SIDE &&
+		(uint64_t)header->width * header->height <= SAVE_MAX_TILES && header->plane_words == ((uint64_t)header->width * header->height + 63) / 64 &&
+		size == sizeof(save_header) + header->plane_words * 3 * sizeof(uint64_t);
+
+	if(!header_valid) {
+		std::cout << name << " is not a save file this version can read\n";
+		return false;
+	}
+
+	// the header is a whole number of uint64_ts, so the planes stay aligned
+	const uint64_t* planes = (const uint64_t*)(header + 1);
+	if(verify_checksum && save_checksum(planes, header->plane_words * 3) != header->checksum) {
+		std::cout << name << " is corrupted, checksum mismatch\n";
+		return false;
+	}
+
+	// bits past the last tile would land on the border row
+	const uint64_t used_bits = ((uint64_t)header->width * header->height) % 64;
+	if(used_bits != 0) {
+		const uint64_t padding = ~0ull << used_bits;
+		for(int plane = 0; plane < 3; plane++) {
+			if(planes[header->plane_words * (plane + 1) - 1] & padding) {
+				std::cout << name << " is corrupted, bits are set past the last tile\n";
+				return false;
+			}
+		}
+	}
+
+	view->header = header;
+	view->mines = planes;
+	view->open = planes + header->plane_words;
+	view->flagged = planes + header->plane_words * 2;
+	return true;
+}
+
+bool save_open(save_view* view, const char* path)
+{
+	if(!map_file(&view->file, path)) {
+		std::cout << "Couldn't open " << path << "\n";
+		return false;
+	}
+
+	if(!save_parse(view, view->file.data, view->file.size, true, path)) {
+		save_close(view);
+		return false;
+	}
+
+	return true;
+}
+
+void save_close(save_view* view)
+{
+	unmap_file(&view->file);
+	*view = save_view();
+}
+
+// calls visit(row, col) for every set bit, skipping empty words so sparse planes cost next to nothing
+template <typename Visit>
+static void for_each_bit(const save_view& view, const uint64_t* plane, Visit visit)
+{
+	const uint64_t width = view.header->width;
+	for(uint64_t word = 0; word < view.header->plane_words; word++) {
+		uint64_t bits = plane[word];
+		while(bits) {
+			const uint64_t bit = word * 64 + std::countr_zero(bits);
+			bits &= bits - 1;
+			visit((int)(bit / width) + 1, (int)(bit % width) + 1);
+		}
+	}
+}
+
+Minesweeper* save_load_game(const save_view& view, storage_layout layout)
+{
+	Minesweeper* game = new Minesweeper(view.header->width, view.header->height, layout);
+	game->seed = view.header->seed;
+
+	for_each_bit(view, view.mines,   [&](int row, int col) { game->add_mine(row, col); });
+	for_each_bit(view, view.open,    [&](int row, int col) { game->tilemap[row][col].open = true; });
+	for_each_bit(view, view.flagged, [&](int row, int col) { game->tilemap[row][col].flagged = true; });
+
+	game->dead = (view.header->flags & SAVE_FLAG_DEAD) != 0;
+	return game;
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "minesweeper.hpp"
+
+constexpr char SAVE_MAGIC[4] = { 'M', 'S', 'W', 'P' };
+constexpr uint32_t SAVE_VERSION = 1;
+
+// the engine indexes tiles with int, border around the board included
+constexpr uint32_t SAVE_MAX_SIDE = INT_MAX - 2;
+constexpr uint64_t SAVE_MAX_TILES = INT_MAX;
+
+constexpr uint32_t SAVE_FLAG_DEAD = 1 << 0;
+
+// followed by the mine, open and flag planes, each width * height bits row by row padded to whole uint64_ts
+struct save_header
+{
+	char magic[4];
+	uint32_t version;
+	uint32_t width, height;
+	uint32_t bombcount;
+	uint32_t flags;
+	uint64_t seed;
+	uint64_t generation; // bumped by every journal snapshot, 0 for manual saves
+	uint64_t plane_words;
+	uint64_t checksum; // over the three planes
+};
+
+// a whole file mapped read only
+struct mapped_file
+{
+	void* data = nullptr;
+	size_t size = 0;
+
+	// no mmap on Windows, the file is read into here instead
+	std::vector<uint64_t> buffer;
+};
+
+bool map_file(mapped_file* file, const char* path);
+void unmap_file(mapped_file* file);
+
+// a save mapped into memory, the planes are read in place without a parsing step
+struct save_view
+{
+	const save_header* header = nullptr;
+	const uint64_t* mines = nullptr;
+	const uint64_t* open = nullptr;
+	const uint64_t* flagged = nullptr;
+
+	// empty for views into memory owned by someone else
+	mapped_file file;
+};
+
+// 1-based like the tilemap
+inline bool save_bit(const save_view& view, const uint64_t* plane, int row, int col)
+{
+	const uint64_t bit = (uint64_t)(row - 1) * view.header->width + (col - 1);
+	return (plane[bit / 64] >> (bit % 64)) & 1;
+}
+
+uint64_t save_checksum(const uint64_t* words, size_t count);
+
+// header and planes in one buffer, ready to be written out from another thread
+void save_pack(const Minesweeper* game, uint64_t generation, std::vector<uint64_t>* data);
+
+// writes to a temporary file next to path and syncs it before and after renaming it over path
+// an interrupted save or a power loss never leaves a broken file behind
+bool save_write(const std::vector<uint64_t>& data, const char* path);
+bool save_game(const Minesweeper* game, const char* path);
+
+// maps path and checks the header and checksum, the view stays valid until save_close
+bool save_open(save_view* view, const char* path);
+void save_close(save_view* view);
+
+// points view at a save already in memory, e.g. a replay keyframe, name is only used for errors
+bool save_parse(save_view* view, const void* data, size_t size, bool verify_checksum, const char* name);
+
+// rebuilds a playable board from the planes
+Minesweeper* save_load_game(const save_view& view, storage_layout layout = STORAGE_ROW_MAJOR);
@@ -0,0 +1,175 @@
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+
+#include "sdf.hpp"
+#include "globals.hpp"
+
+// big enough that the downsampled field still has the glyph corners
+constexpr int SDF_SOURCE_POINTS = 96;
+constexpr int SDF_DOWNSAMPLE = 2;
+
+// distances are clamped to this many source pixels on either side of the edge
+constexpr int SDF_SPREAD = 8;
+
+// coverage mask of a rasterized glyph, anything outside the surface is empty
+struct glyph_mask
+{
+	std::vector<bool> inside;
+	int w, h;
+
+	bool at(int x, int y) const
+	{
+		if(x < 0 || y < 0 || x >= w || y >= h) return false;
+		return inside[y * w + x];
+	}
+};
+
+static glyph_mask rasterize_digit(TTF_Font* font, char digit)
+{
+	const char text[2] = { digit, '\0' };
+	SDL_Surface* rendered = TTF_RenderText_Blended(font, text, {255, 255, 255, 255});
+	if(rendered == NULL) {
+		std::cout << "Couldn't render sdf glyph, ERROR: " << TTF_GetError() << "\n";
+		free_and_quit();
+	}
+
+	SDL_Surface* surface = SDL_ConvertSurfaceFormat(rendered, SDL_PIXELFORMAT_ARGB8888, 0);
+	SDL_FreeSurface(rendered);
+	if(surface == NULL) {
+		std::cout << "Couldn't convert sdf glyph, ERROR: " << SDL_GetError() << "\n";
+		free_and_quit();
+	}
+
+	glyph_mask mask = { std::vector<bool>(surface->w * surface->h), surface->w, surface->h };
+
+	SDL_LockSurface(surface);
+	for(int y = 0; y < surface->h; y++) {
+		const uint32_t* row = (const uint32_t*)((const uint8_t*)surface->pixels + y * surface->pitch);
+		for(int x = 0; x < surface->w; x++)
+			mask.inside[y * surface->w + x] = (row[x] >> 24) >= 128;
+	}
+	SDL_UnlockSurface(surface);
+	SDL_FreeSurface(surface);
+
+	return mask;
+}
+
+// distance in source pixels from (x, y) to the closest pixel on the other side of the edge
+static float edge_distance(const glyph_mask& mask, int x, int y)
+{
+	const bool inside = mask.at(x, y);
+	int closest_squared = SDF_SPREAD * SDF_SPREAD;
+
+	for(int dy = -SDF_SPREAD; dy <= SDF_SPREAD; dy++) {
+		for(int dx = -SDF_SPREAD; dx <= SDF_SPREAD; dx++) {
+			const int distance_squared = dx * dx + dy * dy;
+			if(distance_squared < closest_squared && mask.at(x + dx, y + dy) != inside)
+				closest_squared = distance_squared;
+		}
+	}
+
+	const float distance = std::sqrt((float)closest_squared) - 0.5f;
+	return inside ? distance : -distance;
+}
+
+void sdf_atlas_build(sdf_atlas* atlas, TTF_Font* font)
+{
+	if(TTF_SetFontSize(font, SDF_SOURCE_POINTS) < 0) {
+		std::cout << "Couldn't set font size, ERROR: " << TTF_GetError() << "\n";
+		free_and_quit();
+	}
+
+	glyph_mask masks[8];
+	atlas->w = 0;
+	atlas->h = 0;
+
+	// glyphs are packed side by side in one row
+	for(int i = 0; i < 8; i++) {
+		masks[i] = rasterize_digit(font, (char)('1' + i));
+
+		const int glyph_w = (masks[i].w + 2 * SDF_SPREAD) / SDF_DOWNSAMPLE;
+		const int glyph_h = (masks[i].h + 2 * SDF_SPREAD) / SDF_DOWNSAMPLE;
+		atlas->glyphs[i] = { .x = atlas->w, .y = 0, .w = glyph_w, .h = glyph_h };
+
+		atlas->w += glyph_w;
+		atlas->h = std::max(atlas->h, glyph_h);
+	}
+
+	atlas->pixels.assign(atlas->w * atlas->h, 0);
+	atlas->source_points = SDF_SOURCE_POINTS;
+
+	for(int i = 0; i < 8; i++) {
+		const SDL_Rect& rect = atlas->glyphs[i];
+
+		for(int y = 0; y < rect.h; y++) {
+			for(int x = 0; x < rect.w; x++) {
+				// sample at the center of the downsampled texel
+				const int source_x = x * SDF_DOWNSAMPLE + SDF_DOWNSAMPLE / 2 - SDF_SPREAD;
+				const int source_y = y * SDF_DOWNSAMPLE + SDF_DOWNSAMPLE / 2 - SDF_SPREAD;
+				const float distance = edge_distance(masks[i], source_x, source_y);
+
+				const float value = 128.0f + distance / SDF_SPREAD * 127.0f;
+				atlas->pixels[y * atlas->w + rect.x + x] = (uint8_t)std::clamp(value, 0.0f, 255.0f);
+			}
+		}
+	}
+}
+
+// bilinear sample of the atlas, returns the distance in source pixels
+static float sample_distance(const sdf_atlas* atlas, const SDL_Rect& rect, float u, float v)
+{
+	u = std::clamp(u, 0.0f, rect.w - 1.0f);
+	v = std::clamp(v, 0.0f, rect.h - 1.0f);
+
+	const int x0 = (int)u, y0 = (int)v;
+	const int x1 = std::min(x0 + 1, rect.w - 1), y1 = std::min(y0 + 1, rect.h - 1);
+	const float fx = u - x0, fy = v - y0;
+
+	const uint8_t* row0 = &atlas->pixels[y0 * atlas->w + rect.x];
+	const uint8_t* row1 = &atlas->pixels[y1 * atlas->w + rect.x];
+
+	const float top    = row0[x0] + (row0[x1] - row0[x0]) * fx;
+	const float bottom = row1[x0] + (row1[x1] - row1[x0]) * fx;
+	const float value  = top + (bottom - top) * fy;
+
+	return (value - 128.0f) / 127.0f * SDF_SPREAD;
+}
+
+SDL_Surface* sdf_expand(const sdf_atlas* atlas, int glyph, int point_size, SDL_Color color)
+{
+	const SDL_Rect& rect = atlas->glyphs[glyph];
+
+	// output pixels per source pixel
+	const float scale = (float)point_size / atlas->source_points;
+	const int w = std::max(1, (int)std::lround(rect.w * SDF_DOWNSAMPLE * scale));
+	const int h = std::max(1, (int)std::lround(rect.h * SDF_DOWNSAMPLE * scale));
+
+	SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, w, h, 32, SDL_PIXELFORMAT_ARGB8888);
+	if(surface == NULL) {
+		std::cout << "Couldn't create glyph surface, ERROR: " << SDL_GetError() << "\n";
+		free_and_quit();
+	}
+
+	const uint32_t rgb = (uint32_t)color.r << 16 | (uint32_t)color.g << 8 | color.b;
+	const float texels_per_pixel = 1.0f / (scale * SDF_DOWNSAMPLE);
+
+	SDL_LockSurface(surface);
+	for(int y = 0; y < h; y++) {
+		uint32_t* row = (uint32_t*)((uint8_t*)surface->pixels + y * surface->pitch);
+		const float v = (y + 0.5f) * texels_per_pixel - 0.5f;
+
+		for(int x = 0; x < w; x++) {
+			const float u = (x + 0.5f) * texels_per_pixel - 0.5f;
+
+			// one output pixel wide anti-aliasing band around the edge
+			const float distance = sample_distance(atlas, rect, u, v) * scale;
+			const float coverage = std::clamp(distance + 0.5f, 0.0f, 1.0f);
+
+			row[x] = (uint32_t)(coverage * color.a) << 24 | rgb;
+		}
+	}
+	SDL_UnlockSurface(surface);
+
+	return surface;
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+
+#include <vector>
+
+// signed distance fields of the digits 1-8, 128 is the glyph edge and higher values are inside
+struct sdf_atlas
+{
+	std::vector<uint8_t> pixels;
+	int w = 0, h = 0;
+
+	// glyph i is the digit i+1, rects include the distance spread around the glyph
+	SDL_Rect glyphs[8];
+
+	// point size the glyphs were rasterized at before downsampling
+	int source_points = 0;
+};
+
+// rasterizes the digits once with the given font, the font isn't needed afterwards
+void sdf_atlas_build(sdf_atlas* atlas, TTF_Font* font);
+
+// renders digit index `glyph` at point_size with anti-aliased edges, no FreeType involved
+SDL_Surface* sdf_expand(const sdf_atlas* atlas, int glyph, int point_size, SDL_Color color);
@@ -0,0 +1,336 @@
+#include <iostream>
+#include <cstdlib>
+
+#include "shared_board.hpp"
+
+#if defined(_WIN32) || defined(__EMSCRIPTEN__)
+
+bool shared_board_create(shared_board_writer*, const char*, Minesweeper*)
+{
+	std::cout << "Shared memory export isn't supported on this platform\n";
+	return false;
+}
+
+void shared_board_publish(shared_board_writer*, const Minesweeper*) {}
+void shared_board_reset(shared_board_writer*, Minesweeper*) {}
+void shared_board_destroy(shared_board_writer*) {}
+
+bool shared_board_open(shared_board_reader*, const char*)
+{
+	std::cout << "Shared memory export isn't supported on this platform\n";
+	return false;
+}
+
+void shared_board_close(shared_board_reader*) {}
+
+uint64_t shared_board_read(const shared_board_reader*, uint8_t*, bool*, uint64_t*)
+{
+	return 0;
+}
+
+int run_shared_board_monitor(const char*)
+{
+	std::cout << "Shared memory export isn't supported on this platform\n";
+	return EXIT_FAILURE;
+}
+
+#else
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// how often the monitor prints what it saw
+constexpr uint64_t MONITOR_PRINT_NS = 1000000000;
+
+static uint64_t monotonic_ns()
+{
+	timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+// shm_open wants exactly one leading slash
+static std::string segment_name(const char* name)
+{
+	return name[0] == '/' ? std::string(name) : "/" + std::string(name);
+}
+
+static void begin_write(shared_board_header* header)
+{
+	header->sequence.store(header->sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+}
+
+static void end_write(shared_board_header* header)
+{
+	header->published_ns = monotonic_ns();
+	header->sequence.store(header->sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+// the segment gets the board's own view plane, so tiles are encoded in one place
+static void write_board(shared_board_writer* writer, Minesweeper* game)
+{
+	if(!game->view())
+		game->attach_view();
+
+	shared_board_header* header = writer->header;
+	begin_write(header);
+
+	header->seed = game->seed;
+	header->bombcount = game->bomb_count();
+	header->dead = game->dead;
+	std::memcpy(writer->view, game->view(), (size_t)game->width * game->height);
+
+	end_write(header);
+}
+
+// a segment can be replaced once its game closed it or is gone, a crashed game never sets closed
+static bool segment_abandoned(const char* name)
+{
+	shared_board_reader reader;
+	if(!shared_board_open(&reader, name))
+		return false;
+
+	const bool abandoned = reader.header->closed.load(std::memory_order_acquire) ||
+		(reader.header->pid > 0 && kill((pid_t)reader.header->pid, 0) != 0 && errno == ESRCH);
+	shared_board_close(&reader);
+	return abandoned;
+}
+
+static bool map_segment(shared_board_writer* writer, Minesweeper* game)
+{
+	const std::string name = segment_name(writer->name.c_str());
+	const size_t size = sizeof(shared_board_header) + (size_t)game->width * game->height;
+
+	int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+	if(fd < 0 && errno == EEXIST && segment_abandoned(name.c_str())) {
+		shm_unlink(name.c_str());
+		fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+	}
+
+	if(fd < 0) {
+		if(errno == EEXIST)
+			std::cout << "Shared memory " << name << " is already published by a running game\n";
+		else
+			std::cout << "Couldn't create shared memory " << name << "\n";
+		return false;
+	}
+
+	void* data = ftruncate(fd, size) == 0 ? mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+	close(fd);
+	if(data == MAP_FAILED) {
+		std::cout << "Couldn't map shared memory " << name << "\n";
+		shm_unlink(name.c_str());
+		return false;
+	}
+
+	shared_board_header* header = new(data) shared_board_header();
+	std::memcpy(header->magic, SHARED_BOARD_MAGIC, sizeof(header->magic));
+	header->version = SHARED_BOARD_VERSION;
+	header->width = game->width;
+	header->height = game->height;
+	header->pid = (uint32_t)getpid();
+
+	writer->header = header;
+	writer->view = (uint8_t*)data + sizeof(shared_board_header);
+	writer->size = size;
+
+	write_board(writer, game);
+	return true;
+}
+
+static void unmap_segment(shared_board_writer* writer)
+{
+	writer->header->closed.store(1, std::memory_order_release);
+	munmap(writer->header, writer->size);
+	writer->header = nullptr;
+	writer->view = nullptr;
+}
+
+bool shared_board_create(shared_board_writer* writer, const char* name, Minesweeper* game)
+{
+	writer->name = name;
+	return map_segment(writer, game);
+}
+
+void shared_board_publish(shared_board_writer* writer, const Minesweeper* game)
+{
+	shared_board_header* header = writer->header;
+	if(!header || (game->changed_tiles.empty() && header->dead == (uint32_t)game->dead))
+		return;
+
+	begin_write(header);
+
+	const uint8_t* view = game->view();
+	for(const auto& [row, col] : game->changed_tiles) {
+		const size_t index = (size_t)(row - 1) * game->width + (col - 1);
+		writer->view[index] = view[index];
+	}
+	header->dead = game->dead;
+
+	end_write(header);
+}
+
+void shared_board_reset(shared_board_writer* writer, Minesweeper* game)
+{
+	if(!writer->header)
+		return;
+
+	if(writer->header->width == (uint32_t)game->width && writer->header->height == (uint32_t)game->height) {
+		write_board(writer, game);
+		return;
+	}
+
+	// readers see the old segment closed and open the name again
+	unmap_segment(writer);
+	map_segment(writer, game);
+}
+
+void shared_board_destroy(shared_board_writer* writer)
+{
+	if(!writer->header)
+		return;
+
+	unmap_segment(writer);
+	shm_unlink(segment_name(writer->name.c_str()).c_str());
+}
+
+bool shared_board_open(shared_board_reader* reader, const char* name)
+{
+	const int fd = shm_open(segment_name(name).c_str(), O_RDONLY, 0);
+	if(fd < 0)
+		return false;
+
+	struct stat info;
+	void* data = fstat(fd, &info) == 0 && (size_t)info.st_size >= sizeof(shared_board_header) ?
+		mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+	close(fd);
+	if(data == MAP_FAILED)
+		return false;
+
+	const shared_board_header* header = (const shared_board_header*)data;
+	if(std::memcmp(header->magic, SHARED_BOARD_MAGIC, sizeof(SHARED_BOARD_MAGIC)) != 0 || header->version != SHARED_BOARD_VERSION ||
+		(size_t)info.st_size != sizeof(shared_board_header) + (size_t)header->width * header->height)
+	{
+		munmap(data, info.st_size);
+		return false;
+	}
+
+	reader->header = header;
+	reader->view = (const uint8_t*)data + sizeof(shared_board_header);
+	reader->size = info.st_size;
+	return true;
+}
+
+void shared_board_close(shared_board_reader* reader)
+{
+	if(reader->header)
+		munmap((void*)reader->header, reader->size);
+
+	*reader = shared_board_reader();
+}
+
+uint64_t shared_board_read(const shared_board_reader* reader, uint8_t* out, bool* dead, uint64_t* published_ns)
+{
+	const shared_board_header* header = reader->header;
+	const size_t tiles = (size_t)header->width * header->height;
+
+	for(;;) {
+		const uint64_t before = header->sequence.load(std::memory_order_acquire);
+		if(before & 1)
+			continue;
+
+		std::memcpy(out, reader->view, tiles);
+		*dead = header->dead != 0;
+		*published_ns = header->published_ns;
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if(header->sequence.load(std::memory_order_relaxed) == before)
+			return before;
+	}
+}
+
+int run_shared_board_monitor(const char* name)
+{
+	shared_board_reader reader;
+	if(!shared_board_open(&reader, name)) {
+		std::cout << "Nothing is published as " << name << "\n";
+		return EXIT_FAILURE;
+	}
+
+	std::vector<uint8_t> board;
+	uint64_t last_sequence = 0;
+	bool caught_up = false;
+	uint64_t updates = 0, total_ns = 0, worst_ns = 0;
+	uint64_t last_print = monotonic_ns();
+
+	printf("Watching %s, %ux%u\n", name, reader.header->width, reader.header->height);
+
+	for(;;) {
+		if(reader.header->closed.load(std::memory_order_acquire)) {
+			// either the game exited or it moved to a new segment under the same name
+			shared_board_close(&reader);
+			if(!shared_board_open(&reader, name) || reader.header->closed.load(std::memory_order_acquire))
+				break;
+
+			last_sequence = 0;
+			caught_up = false;
+			printf("Board replaced, now %ux%u\n", reader.header->width, reader.header->height);
+		}
+
+		// spinning is what gets changes within microseconds, a real tool would sleep between checks
+		const uint64_t sequence = reader.header->sequence.load(std::memory_order_acquire);
+		const uint64_t now = monotonic_ns();
+		if(sequence != last_sequence && !(sequence & 1)) {
+			board.resize((size_t)reader.header->width * reader.header->height);
+
+			bool dead = false;
+			uint64_t published_ns = 0;
+			last_sequence = shared_board_read(&reader, board.data(), &dead, &published_ns);
+
+			// the first read only catches up with what was there before the monitor started
+			if(caught_up) {
+				const uint64_t latency = now > published_ns ? now - published_ns : 0;
+				updates++;
+				total_ns += latency;
+				worst_ns = std::max(worst_ns, latency);
+			}
+			caught_up = true;
+		}
+		else {
+			std::this_thread::yield();
+		}
+
+		if(now - last_print >= MONITOR_PRINT_NS) {
+			size_t open = 0;
+			for(uint8_t tile : board)
+				open += tile < TILE_VIEW_CLOSED;
+
+			if(updates > 0)
+				printf("%llu updates, %.1f us average and %.1f us worst from publish to seen, %zu tiles open\n",
+					(unsigned long long)updates, total_ns / 1000.0 / updates, worst_ns / 1000.0, open);
+			fflush(stdout);
+
+			updates = total_ns = worst_ns = 0;
+			last_print = now;
+		}
+	}
+
+	shared_board_close(&reader);
+	std::cout << "The game closed " << name << "\n";
+	return EXIT_SUCCESS;
+}
+
+#endif
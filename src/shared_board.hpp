@@ -0,0 +1,73 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "minesweeper.hpp"
+
+constexpr char SHARED_BOARD_MAGIC[4] = { 'M', 'S', 'W', 'S' };
+constexpr uint32_t SHARED_BOARD_VERSION = 2;
+
+// the counters are read by other processes, they have to work without a lock
+static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free);
+
+// at the start of the segment, followed by width * height TileView bytes row by row
+// sequence is odd while the game writes, a reader copies what it needs and starts over if sequence moved meanwhile
+struct shared_board_header
+{
+	char magic[4];
+	uint32_t version;
+	uint32_t width, height;
+	std::atomic<uint64_t> sequence;
+
+	// CLOCK_MONOTONIC when the last change was published, readers on the same machine can tell how old it is
+	uint64_t published_ns;
+	uint64_t seed;
+	uint32_t bombcount;
+	uint32_t dead;
+
+	// set once the game has moved on to another segment (a board of another size) or exited
+	std::atomic<uint32_t> closed;
+
+	// the game writing it, a segment whose game is gone can be taken over
+	uint32_t pid;
+};
+
+// the game's side, /dev/shm/name on Linux
+struct shared_board_writer
+{
+	std::string name;
+	shared_board_header* header = nullptr;
+	uint8_t* view = nullptr;
+	size_t size = 0;
+};
+
+// fails if a running game already publishes name, the board's view plane is attached if it has none
+bool shared_board_create(shared_board_writer* writer, const char* name, Minesweeper* game);
+
+// copies only the tiles in changed_tiles from the board's view plane, call every frame before they're cleared
+void shared_board_publish(shared_board_writer* writer, const Minesweeper* game);
+
+// the board was replaced, rewrites all of it and starts a new segment if the size changed
+void shared_board_reset(shared_board_writer* writer, Minesweeper* game);
+
+// marks the segment closed and removes the name, readers keep their mapping until they close it
+void shared_board_destroy(shared_board_writer* writer);
+
+struct shared_board_reader
+{
+	const shared_board_header* header = nullptr;
+	const uint8_t* view = nullptr;
+	size_t size = 0;
+};
+
+bool shared_board_open(shared_board_reader* reader, const char* name);
+void shared_board_close(shared_board_reader* reader);
+
+// copies a consistent board into out (width * height bytes), returns the even sequence it was copied at
+uint64_t shared_board_read(const shared_board_reader* reader, uint8_t* out, bool* dead, uint64_t* published_ns);
+
+// --watch-shm: follows a published board like an external tool would and prints how long changes took to show up
+// returns the process exit code once the game closes the segment
+int run_shared_board_monitor(const char* name);
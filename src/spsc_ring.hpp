@@ -0,0 +1,40 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+
+// fixed size ring buffer for exactly one producer thread and one consumer thread, never locks
+template <typename T, size_t Capacity>
+class SpscRing {
+	static_assert((Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+
+	// indices only ever grow, the slot is index & (Capacity - 1)
+	// kept on separate cache lines so the two threads don't fight over them
+	alignas(64) std::atomic<size_t> head = 0; // next slot to read, written by the consumer
+	alignas(64) std::atomic<size_t> tail = 0; // next slot to write, written by the producer
+	alignas(64) T items[Capacity];
+
+public:
+	// returns false if the ring is full
+	bool push(const T& item)
+	{
+		const size_t write = tail.load(std::memory_order_relaxed);
+		if(write - head.load(std::memory_order_acquire) == Capacity)
+			return false;
+
+		items[write & (Capacity - 1)] = item;
+		tail.store(write + 1, std::memory_order_release);
+		return true;
+	}
+
+	// returns false if the ring is empty
+	bool pop(T* item)
+	{
+		const size_t read = head.load(std::memory_order_relaxed);
+		if(read == tail.load(std::memory_order_acquire))
+			return false;
+
+		*item = items[read & (Capacity - 1)];
+		head.store(read + 1, std::memory_order_release);
+		return true;
+	}
+};
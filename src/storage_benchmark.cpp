@@ -0,0 +1,112 @@
+#include <iostream>
+#include <chrono>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+#include "storage_benchmark.hpp"
+#include "minesweeper.hpp"
+
+// the best of a few runs, the first one also pays for page faults
+constexpr int BENCHMARK_RUNS = 3;
+
+// every layout and run times the same board, otherwise the mine layout decides the flood fill size
+constexpr uint64_t BENCHMARK_SEED = 1;
+
+// about what the sprite renderer reads at default zoom on a 1080p screen
+constexpr int SCAN_VIEW_COLS = 64;
+constexpr int SCAN_VIEW_ROWS = 36;
+
+// a window much taller than wide, e.g. a portrait monitor zoomed far out
+constexpr int SCAN_STRIP_COLS = 8;
+
+struct storage_timings
+{
+	double generate_ms = 1e30;
+	double flood_fill_ms = 1e30;
+	double scan_ms = 1e30;
+	double strip_scan_ms = 1e30;
+	size_t opened = 0;
+};
+
+static double elapsed_ms(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// reads every tile of view_cols x view_rows viewports tiled over the whole board in the order render_sprites does
+static unsigned scan_viewports(const Minesweeper* game, int view_cols, int view_rows)
+{
+	unsigned checksum = 0;
+
+	for(int first_row = 1; first_row <= game->height; first_row += view_rows) {
+		for(int first_col = 1; first_col <= game->width; first_col += view_cols) {
+			const int last_row = std::min(game->height, first_row + view_rows - 1);
+			const int last_col = std::min(game->width, first_col + view_cols - 1);
+
+			for(int row = first_row; row <= last_row; row++) {
+				for(int col = first_col; col <= last_col; col++) {
+					const Tile& tile = game->tilemap[row][col];
+					checksum += tile.data + tile.open * 16 + tile.flagged * 32;
+				}
+			}
+		}
+	}
+
+	return checksum;
+}
+
+static storage_timings measure(int width, int height, int bombcount, storage_layout layout)
+{
+	storage_timings timings;
+	unsigned checksum = 0;
+
+	for(int run = 0; run < BENCHMARK_RUNS; run++) {
+		auto start = std::chrono::steady_clock::now();
+		Minesweeper game(width, height, bombcount, BENCHMARK_SEED, layout);
+		timings.generate_ms = std::min(timings.generate_ms, elapsed_ms(start));
+
+		// opening on a mine would end the run early, pick the first empty tile from the middle on
+		int row = (height + 1) / 2, col = (width + 1) / 2;
+		while(game.tilemap[row][col].data != TILE_EMPTY && col < width)
+			col++;
+
+		start = std::chrono::steady_clock::now();
+		game.open_tile(row, col);
+		timings.flood_fill_ms = std::min(timings.flood_fill_ms, elapsed_ms(start));
+		timings.opened = game.changed_tiles.size();
+
+		start = std::chrono::steady_clock::now();
+		checksum += scan_viewports(&game, SCAN_VIEW_COLS, SCAN_VIEW_ROWS);
+		timings.scan_ms = std::min(timings.scan_ms, elapsed_ms(start));
+
+		start = std::chrono::steady_clock::now();
+		checksum += scan_viewports(&game, SCAN_STRIP_COLS, height);
+		timings.strip_scan_ms = std::min(timings.strip_scan_ms, elapsed_ms(start));
+	}
+
+	// keeps the scans from being optimized away
+	if(checksum == 1)
+		std::cout << "\n";
+
+	return timings;
+}
+
+int run_storage_benchmark(int width, int height, int bombcount)
+{
+	const struct { storage_layout layout; const char* name; } layouts[] = {
+		{ STORAGE_ROW_MAJOR, "row-major" },
+		{ STORAGE_BLOCKED,   "blocked 8x8" },
+	};
+
+	printf("%dx%d board, %d bombs, best of %d runs\n", width, height, bombcount, BENCHMARK_RUNS);
+	printf("%-12s %12s %14s %16s %14s %12s\n", "layout", "generate ms", "flood fill ms", "viewport scan ms", "strip scan ms", "opened");
+
+	for(const auto& [layout, name] : layouts) {
+		const storage_timings timings = measure(width, height, bombcount, layout);
+		printf("%-12s %12.1f %14.1f %16.1f %14.1f %12zu\n", name,
+			timings.generate_ms, timings.flood_fill_ms, timings.scan_ms, timings.strip_scan_ms, timings.opened);
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,5 @@
+#pragma once
+
+// compares tile storage layouts on generation, a full board flood fill and viewport sized scans
+// prints a table and returns the process exit code, build with release=1 for meaningful numbers
+int run_storage_benchmark(int width, int height, int bombcount);
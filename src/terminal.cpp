@@ -0,0 +1,521 @@
+#include <iostream>
+#include <cstddef>
+
+#include "terminal.hpp"
+
+#ifdef _WIN32
+
+int run_terminal(int, int, int)
+{
+	std::cout << "The terminal frontend isn't supported on Windows\n";
+	return EXIT_FAILURE;
+}
+
+int run_terminal_infinite(double, size_t)
+{
+	std::cout << "The terminal frontend isn't supported on Windows\n";
+	return EXIT_FAILURE;
+}
+
+#else
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+
+#include "minesweeper.hpp"
+#include "infinite_board.hpp"
+
+// redraw at least this often so terminal resizes are noticed without input
+constexpr int TERMINAL_POLL_MS = 100;
+
+enum term_style : uint8_t
+{
+	STYLE_DEFAULT = 0,
+	STYLE_UNOPENED,
+	STYLE_FLAG,
+	STYLE_BOMB,
+	STYLE_NUMBER_1,
+	STYLE_NUMBER_2,
+	STYLE_NUMBER_3,
+	STYLE_NUMBER_4,
+	STYLE_NUMBER_5,
+	STYLE_NUMBER_6,
+	STYLE_NUMBER_7,
+	STYLE_NUMBER_8,
+	STYLE_STATUS,
+};
+
+// SGR sequences indexed by term_style, the number colors follow the classic game
+static const char* const STYLE_SEQUENCES[] = {
+	"\x1b[0m",
+	"\x1b[0;90m",
+	"\x1b[0;1;91m",
+	"\x1b[0;1;97;41m",
+	"\x1b[0;94m",
+	"\x1b[0;32m",
+	"\x1b[0;91m",
+	"\x1b[0;34m",
+	"\x1b[0;31m",
+	"\x1b[0;36m",
+	"\x1b[0;1;30m",
+	"\x1b[0;37m",
+	"\x1b[0;7m",
+};
+
+struct term_cell
+{
+	char ch = ' ';
+	term_style style = STYLE_DEFAULT;
+	bool cursor = false;
+
+	bool operator==(const term_cell&) const = default;
+};
+
+struct terminal_state
+{
+	// exactly one of these is set
+	Minesweeper* game = nullptr;
+	InfiniteMinesweeper* infinite = nullptr;
+
+	int board_width, board_height, bombcount;
+	double density;
+	size_t memory_budget;
+
+	// 1-based like the tilemap, unbounded in both directions on infinite boards
+	int64_t cursor_row = 1, cursor_col = 1;
+
+	// top left tile on screen, only scrolls when the cursor leaves the screen so moving stays a small diff
+	int64_t view_row = 1, view_col = 1;
+
+	// recenter the view on the cursor on the next frame, the cursor jumped somewhere else
+	bool center_view = false;
+
+	int term_w = 0, term_h = 0;
+	std::vector<term_cell> last_frame;
+	std::vector<term_cell> frame;
+
+	std::string output;
+	bool running = true;
+};
+
+static termios g_original_termios;
+
+static void restore_terminal()
+{
+	// show the cursor, reset colors and leave the alternate screen
+	const char reset[] = "\x1b[?25h\x1b[0m\x1b[?1049l";
+	[[maybe_unused]] ssize_t written = write(STDOUT_FILENO, reset, sizeof(reset) - 1);
+	tcsetattr(STDIN_FILENO, TCSAFLUSH, &g_original_termios);
+}
+
+static bool enter_raw_mode()
+{
+	if(tcgetattr(STDIN_FILENO, &g_original_termios) < 0) {
+		std::cout << "stdin is not a terminal\n";
+		return false;
+	}
+
+	termios raw = g_original_termios;
+	raw.c_iflag &= ~(ICRNL | IXON);
+	// without ISIG Ctrl-C arrives as a key and quits through the normal exit, which puts the terminal back
+	raw.c_lflag &= ~(ECHO | ICANON | IEXTEN | ISIG);
+	raw.c_cc[VMIN] = 0;
+	raw.c_cc[VTIME] = 0;
+	tcsetattr(STDIN_FILENO, TCSAFLUSH, &raw);
+
+	const char setup[] = "\x1b[?1049h\x1b[?25l\x1b[2J";
+	[[maybe_unused]] ssize_t written = write(STDOUT_FILENO, setup, sizeof(setup) - 1);
+
+	std::atexit(restore_terminal);
+	return true;
+}
+
+static void write_all(const std::string& data)
+{
+	size_t offset = 0;
+	while(offset < data.size()) {
+		const ssize_t written = write(STDOUT_FILENO, data.data() + offset, data.size() - offset);
+		if(written <= 0)
+			return;
+		offset += written;
+	}
+}
+
+static term_cell tile_cell(bool dead, const Tile& tile)
+{
+	if(tile.open) {
+		if(tile.data == TILE_BOMB)  return { .ch = '*', .style = STYLE_BOMB };
+		if(tile.data == TILE_EMPTY) return { .ch = ' ', .style = STYLE_DEFAULT };
+		return { .ch = (char)('0' + tile.data), .style = (term_style)(STYLE_NUMBER_1 + (int)tile.data - 1) };
+	}
+
+	if(dead && tile.data == TILE_BOMB) return { .ch = '*', .style = STYLE_BOMB };
+	if(tile.flagged) return { .ch = 'F', .style = STYLE_FLAG };
+	return { .ch = '.', .style = STYLE_UNOPENED };
+}
+
+// fills state->frame with the part of the board around the cursor and a status line at the bottom
+// only chunks overlapping the screen are looked at, never generated ones are drawn closed
+static void build_infinite_board(terminal_state* state, int board_rows)
+{
+	InfiniteMinesweeper* infinite = state->infinite;
+
+	const int64_t first_row = state->view_row, last_row = state->view_row + board_rows - 1;
+	const int64_t first_col = state->view_col, last_col = state->view_col + state->term_w - 1;
+
+	for(int y = 0; y < board_rows; y++)
+		for(int x = 0; x < state->term_w; x++)
+			state->frame[y * state->term_w + x] = tile_cell(false, Tile());
+
+	const chunk_coord first_chunk = chunk_of(first_row, first_col);
+	const chunk_coord last_chunk = chunk_of(last_row, last_col);
+
+	for(int64_t chunk_row = first_chunk.row; chunk_row <= last_chunk.row; chunk_row++) {
+		for(int64_t chunk_col = first_chunk.col; chunk_col <= last_chunk.col; chunk_col++) {
+			// untouched chunks are all closed, until the game is lost and their mines show
+			const board_chunk* chunk = infinite->find_chunk({chunk_row, chunk_col});
+			if(!chunk && !infinite->dead)
+				continue;
+
+			const int64_t row_begin = std::max(first_row, chunk_row << CHUNK_SHIFT);
+			const int64_t row_end   = std::min(last_row, (chunk_row << CHUNK_SHIFT) + CHUNK_SIZE - 1);
+			const int64_t col_begin = std::max(first_col, chunk_col << CHUNK_SHIFT);
+			const int64_t col_end   = std::min(last_col, (chunk_col << CHUNK_SHIFT) + CHUNK_SIZE - 1);
+
+			for(int64_t row = row_begin; row <= row_end; row++)
+				for(int64_t col = col_begin; col <= col_end; col++)
+					state->frame[(row - first_row) * state->term_w + (col - first_col)] =
+						tile_cell(infinite->dead, chunk ? chunk->tiles[chunk_index(row, col)] : infinite->peek_tile(row, col));
+		}
+	}
+
+	const int64_t cursor_y = state->cursor_row - first_row, cursor_x = state->cursor_col - first_col;
+	state->frame[cursor_y * state->term_w + cursor_x].cursor = true;
+}
+
+static void build_frame(terminal_state* state)
+{
+	const Minesweeper* game = state->game;
+	const int board_rows = std::max(0, state->term_h - 1);
+
+	if(state->center_view) {
+		state->view_row = state->cursor_row - board_rows / 2;
+		state->view_col = state->cursor_col - state->term_w / 2;
+		state->center_view = false;
+	}
+
+	if(state->cursor_col < state->view_col)
+		state->view_col = state->cursor_col;
+	else if(state->cursor_col >= state->view_col + state->term_w)
+		state->view_col = state->cursor_col - state->term_w + 1;
+
+	if(state->cursor_row < state->view_row)
+		state->view_row = state->cursor_row;
+	else if(state->cursor_row >= state->view_row + board_rows)
+		state->view_row = state->cursor_row - board_rows + 1;
+
+	std::fill(state->frame.begin(), state->frame.end(), term_cell());
+
+	char size[64];
+	bool dead = false;
+
+	// a one row terminal only has room for the status line, the cursor would land above the frame
+	if(state->infinite) {
+		if(board_rows > 0)
+			build_infinite_board(state, board_rows);
+		snprintf(size, sizeof(size), "infinite, %zu chunks, %zu on disk", state->infinite->resident_chunks(), state->infinite->spilled_chunks());
+		dead = state->infinite->dead;
+	}
+	else {
+		state->view_col = std::clamp<int64_t>(state->view_col, 1, std::max(1, game->width  - state->term_w + 1));
+		state->view_row = std::clamp<int64_t>(state->view_row, 1, std::max(1, game->height - board_rows + 1));
+
+		const int first_col = (int)state->view_col;
+		const int first_row = (int)state->view_row;
+
+		for(int y = 0; y < board_rows && first_row + y <= game->height; y++) {
+			const int row = first_row + y;
+			for(int x = 0; x < state->term_w && first_col + x <= game->width; x++) {
+				const int col = first_col + x;
+
+				term_cell cell = tile_cell(game->dead, game->tilemap[row][col]);
+				cell.cursor = row == state->cursor_row && col == state->cursor_col;
+				state->frame[y * state->term_w + x] = cell;
+			}
+		}
+
+		snprintf(size, sizeof(size), "%dx%d", game->width, game->height);
+		dead = game->dead;
+	}
+
+	char status[192];
+	const int status_len = snprintf(status, sizeof(status), " %s  (%lld,%lld)  %s  arrows/hjkl move, space open, f flag, n new, q quit",
+		size, (long long)state->cursor_row, (long long)state->cursor_col, dead ? "BOOM" : "");
+
+	term_cell* status_row = &state->frame[board_rows * state->term_w];
+	for(int x = 0; x < state->term_w; x++) {
+		status_row[x].style = STYLE_STATUS;
+		if(x < status_len)
+			status_row[x].ch = status[x];
+	}
+}
+
+// writes only the cells that differ from the last frame
+static void present_frame(terminal_state* state)
+{
+	std::string& out = state->output;
+	out.clear();
+
+	int style = -1;
+	int next_x = -1, next_y = -1; // where the terminal cursor is after the last write
+
+	for(int y = 0; y < state->term_h; y++) {
+		for(int x = 0; x < state->term_w; x++) {
+			const int index = y * state->term_w + x;
+			const term_cell& cell = state->frame[index];
+			if(cell == state->last_frame[index])
+				continue;
+
+			if(x != next_x || y != next_y) {
+				char move[32];
+				snprintf(move, sizeof(move), "\x1b[%d;%dH", y + 1, x + 1);
+				out += move;
+			}
+
+			const int cell_style = cell.cursor ? -2 : cell.style;
+			if(cell_style != style) {
+				out += STYLE_SEQUENCES[cell.style];
+				if(cell.cursor)
+					out += "\x1b[7m";
+				style = cell_style;
+			}
+
+			out += cell.ch;
+			next_x = x + 1;
+			next_y = y;
+		}
+	}
+
+	if(!out.empty())
+		write_all(out);
+
+	std::swap(state->frame, state->last_frame);
+}
+
+// resizing invalidates everything on screen
+static void update_terminal_size(terminal_state* state)
+{
+	winsize size = {};
+	int w = 80, h = 24;
+	if(ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0 && size.ws_col > 0 && size.ws_row > 0) {
+		w = size.ws_col;
+		h = size.ws_row;
+	}
+
+	if(w == state->term_w && h == state->term_h)
+		return;
+
+	state->term_w = w;
+	state->term_h = h;
+
+	// last frame is filled with a cell that never matches so everything is rewritten
+	state->last_frame.assign(w * h, term_cell { .ch = '\0' });
+	state->frame.assign(w * h, term_cell());
+	write_all("\x1b[0m\x1b[2J");
+}
+
+static void handle_infinite_key(terminal_state* state, char key)
+{
+	InfiniteMinesweeper* &infinite = state->infinite;
+
+	switch(key)
+	{
+		case 'h': state->cursor_col--; break;
+		case 'l': state->cursor_col++; break;
+		case 'k': state->cursor_row--; break;
+		case 'j': state->cursor_row++; break;
+
+		case ' ': case '\r': case 'o':
+			infinite->open_tile(state->cursor_row, state->cursor_col);
+			break;
+
+		case 'f':
+			infinite->flag_tile(state->cursor_row, state->cursor_col);
+			break;
+
+		case 'n':
+			delete infinite;
+			infinite = new InfiniteMinesweeper(std::random_device()(), state->density, state->memory_budget);
+			state->cursor_row = state->cursor_col = 0;
+			state->center_view = true;
+			break;
+
+		case 'q':
+			state->running = false;
+			break;
+
+		default:
+			break;
+	}
+
+	infinite->changed_tiles.clear();
+}
+
+// returns how many bytes the key took, 0 if an escape sequence hasn't fully arrived yet
+static int handle_key(terminal_state* state, const char* input, int length)
+{
+	Minesweeper* &game = state->game;
+	int consumed = 1;
+
+	// arrow keys arrive as ESC [ A-D or ESC O A-D, other sequences end at their first byte in @ to ~ and are skipped
+	char key = input[0];
+	if(key == '\x1b') {
+		if(length < 2)
+			return 0;
+		if(input[1] != '[' && input[1] != 'O')
+			return 1;
+
+		int end = 2;
+		while(end < length && (input[end] < '@' || input[end] > '~'))
+			end++;
+		if(end == length)
+			return 0;
+
+		consumed = end + 1;
+		switch(input[end]) {
+			case 'A': key = 'k'; break;
+			case 'B': key = 'j'; break;
+			case 'C': key = 'l'; break;
+			case 'D': key = 'h'; break;
+			default: return consumed;
+		}
+	}
+	else if(key == '\x03') {
+		key = 'q';
+	}
+
+	if(state->infinite) {
+		handle_infinite_key(state, key);
+		return consumed;
+	}
+
+	switch(key)
+	{
+		case 'h': state->cursor_col = std::max<int64_t>(1, state->cursor_col - 1); break;
+		case 'l': state->cursor_col = std::min<int64_t>(game->width, state->cursor_col + 1); break;
+		case 'k': state->cursor_row = std::max<int64_t>(1, state->cursor_row - 1); break;
+		case 'j': state->cursor_row = std::min<int64_t>(game->height, state->cursor_row + 1); break;
+
+		case ' ': case '\r': case 'o':
+			game->open_tile(state->cursor_row, state->cursor_col);
+			break;
+
+		case 'f':
+			game->flag_tile(state->cursor_row, state->cursor_col);
+			break;
+
+		case 'n':
+			delete game;
+			game = new Minesweeper(state->board_width, state->board_height, state->bombcount);
+			break;
+
+		case 'q':
+			state->running = false;
+			break;
+
+		default:
+			break;
+	}
+
+	// the terminal redraws from the tilemap, nothing consumes the change list
+	game->changed_tiles.clear();
+	return consumed;
+}
+
+static int terminal_loop(terminal_state* state)
+{
+	if(!enter_raw_mode())
+		return EXIT_FAILURE;
+
+	// an escape sequence split across reads waits here for the rest
+	char input[64];
+	int pending = 0;
+	while(state->running) {
+		update_terminal_size(state);
+		build_frame(state);
+		present_frame(state);
+
+		// a lone ESC, or a sequence whose rest never came, is dropped once input goes quiet
+		pollfd stdin_poll = { .fd = STDIN_FILENO, .events = POLLIN, .revents = 0 };
+		if(poll(&stdin_poll, 1, TERMINAL_POLL_MS) <= 0) {
+			pending = 0;
+			continue;
+		}
+
+		const ssize_t length = read(STDIN_FILENO, input + pending, sizeof(input) - pending);
+		if(length <= 0)
+			continue;
+		pending += (int)length;
+
+		int offset = 0;
+		while(offset < pending && state->running) {
+			const int consumed = handle_key(state, input + offset, pending - offset);
+			if(consumed == 0)
+				break;
+			offset += consumed;
+		}
+
+		// no escape sequence is this long, whatever filled the buffer isn't one
+		std::memmove(input, input + offset, pending - offset);
+		pending = pending - offset == (int)sizeof(input) ? 0 : pending - offset;
+	}
+
+	return EXIT_SUCCESS;
+}
+
+int run_terminal(int width, int height, int bombcount)
+{
+	terminal_state state = {};
+	state.board_width = width;
+	state.board_height = height;
+	state.bombcount = bombcount;
+	state.game = new Minesweeper(width, height, bombcount);
+	state.cursor_row = (height + 1) / 2;
+	state.cursor_col = (width + 1) / 2;
+	state.view_row = state.cursor_row;
+	state.view_col = state.cursor_col;
+
+	const int result = terminal_loop(&state);
+
+	delete state.game;
+	return result;
+}
+
+int run_terminal_infinite(double density, size_t memory_budget)
+{
+	terminal_state state = {};
+	state.density = density;
+	state.memory_budget = memory_budget;
+	state.infinite = new InfiniteMinesweeper(std::random_device()(), density, memory_budget);
+
+	// the tiles around the origin are always safe, start there
+	state.cursor_row = state.cursor_col = 0;
+	state.center_view = true;
+
+	const int result = terminal_loop(&state);
+
+	delete state.infinite;
+	return result;
+}
+
+#endif
@@ -0,0 +1,10 @@
+#pragma once
+#include <cstddef>
+
+// plays in the terminal with ANSI escape sequences, only cells that changed since the last frame are written
+// returns the process exit code, not supported on Windows
+int run_terminal(int width, int height, int bombcount);
+
+// same frontend on an unbounded board generated in chunks as it's explored, density is the mine probability per tile
+// chunks past memory_budget bytes are spilled to a temporary file
+int run_terminal_infinite(double density, size_t memory_budget);
@@ -0,0 +1,71 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+enum storage_layout
+{
+	// one row after another, neighbors above and below are a whole row apart
+	STORAGE_ROW_MAJOR,
+
+	// 8x8 tiles per block, a tile's 8 neighbors are almost always in the same 192 bytes
+	STORAGE_BLOCKED,
+};
+
+constexpr int STORAGE_BLOCK_SHIFT = 3;
+constexpr int STORAGE_BLOCK_SIZE = 1 << STORAGE_BLOCK_SHIFT;
+
+// 2D tile storage indexed as grid[row][col] whatever the layout is
+template <typename T>
+class Grid {
+	storage_layout layout;
+	int rows, cols;
+
+	// row-major: tiles per row, blocked: blocks per row of blocks
+	int stride;
+	std::vector<T> cells;
+
+public:
+	Grid() : layout(STORAGE_ROW_MAJOR), rows(0), cols(0), stride(0) {}
+
+	Grid(int rows, int cols, storage_layout layout) : layout(layout), rows(rows), cols(cols)
+	{
+		if(layout == STORAGE_BLOCKED) {
+			const int block_rows = (rows + STORAGE_BLOCK_SIZE - 1) >> STORAGE_BLOCK_SHIFT;
+			stride = (cols + STORAGE_BLOCK_SIZE - 1) >> STORAGE_BLOCK_SHIFT;
+			cells.assign((size_t)block_rows * stride * STORAGE_BLOCK_SIZE * STORAGE_BLOCK_SIZE, T());
+		}
+		else {
+			stride = cols;
+			cells.assign((size_t)rows * cols, T());
+		}
+	}
+
+	size_t index(int row, int col) const
+	{
+		if(layout == STORAGE_ROW_MAJOR)
+			return (size_t)row * stride + col;
+
+		const size_t block = (size_t)(row >> STORAGE_BLOCK_SHIFT) * stride + (col >> STORAGE_BLOCK_SHIFT);
+		return (block << (2 * STORAGE_BLOCK_SHIFT)) + ((row & (STORAGE_BLOCK_SIZE - 1)) << STORAGE_BLOCK_SHIFT) + (col & (STORAGE_BLOCK_SIZE - 1));
+	}
+
+	// what grid[row] returns so grid[row][col] reads like the old nested vectors
+	template <typename Cell>
+	struct row_ref {
+		Cell* grid;
+		int row;
+
+		auto& operator[](int col) const { return grid->cells[grid->index(row, col)]; }
+	};
+
+	row_ref<Grid> operator[](int row) { return { this, row }; }
+	row_ref<const Grid> operator[](int row) const { return { this, row }; }
+
+	void fill(const T& value) { std::fill(cells.begin(), cells.end(), value); }
+
+	storage_layout storage() const { return layout; }
+	int row_count() const { return rows; }
+	int col_count() const { return cols; }
+	size_t size_bytes() const { return cells.size() * sizeof(T); }
+};
@@ -0,0 +1,245 @@
+#include <algorithm>
+
+#include "undo_history.hpp"
+
+static void put_varint(std::vector<uint8_t>* out, uint64_t value)
+{
+	while(value >= 0x80) {
+		out->push_back((uint8_t)(value | 0x80));
+		value >>= 7;
+	}
+
+	out->push_back((uint8_t)value);
+}
+
+static uint64_t get_varint(const uint8_t** in)
+{
+	uint64_t value = 0;
+	int shift = 0;
+	while(**in & 0x80) {
+		value |= (uint64_t)(**in & 0x7f) << shift;
+		shift += 7;
+		(*in)++;
+	}
+
+	value |= (uint64_t)**in << shift;
+	(*in)++;
+	return value;
+}
+
+static void flip_bit(std::vector<uint64_t>& plane, uint64_t index)
+{
+	plane[index / 64] ^= 1ull << (index % 64);
+}
+
+// sorts the flips, drops tiles that flipped back to where they started and writes the rest as runs
+static void encode_runs(std::vector<uint64_t>* flips, std::vector<uint8_t>* runs)
+{
+	std::sort(flips->begin(), flips->end());
+
+	uint64_t previous_end = 0;
+	uint64_t run_start = 0, run_length = 0;
+	auto end_run = [&]() {
+		put_varint(runs, run_start - previous_end);
+		put_varint(runs, run_length);
+		previous_end = run_start + run_length;
+	};
+
+	for(size_t i = 0; i < flips->size();) {
+		const uint64_t index = (*flips)[i];
+		size_t next = i;
+		while(next < flips->size() && (*flips)[next] == index)
+			next++;
+
+		const bool flipped = (next - i) % 2 == 1;
+		i = next;
+		if(!flipped)
+			continue;
+
+		if(run_length > 0 && index == run_start + run_length) {
+			run_length++;
+			continue;
+		}
+
+		if(run_length > 0)
+			end_run();
+
+		run_start = index;
+		run_length = 1;
+	}
+
+	if(run_length > 0)
+		end_run();
+
+	flips->clear();
+	runs->shrink_to_fit();
+}
+
+template <typename Visit>
+static void for_each_run_tile(const std::vector<uint8_t>& runs, Visit visit)
+{
+	const uint8_t* in = runs.data();
+	const uint8_t* end = in + runs.size();
+
+	uint64_t position = 0;
+	while(in < end) {
+		position += get_varint(&in);
+		const uint64_t length = get_varint(&in);
+
+		for(uint64_t index = position; index < position + length; index++)
+			visit(index);
+		position += length;
+	}
+}
+
+static size_t delta_memory(const undo_delta& delta)
+{
+	return sizeof(undo_delta) + delta.open_runs.capacity() + delta.flag_runs.capacity();
+}
+
+static void apply_delta(undo_history* history, Minesweeper* game, const undo_delta& delta)
+{
+	const uint64_t width = game->width;
+
+	for_each_run_tile(delta.open_runs, [&](uint64_t index) {
+		const int row = (int)(index / width) + 1, col = (int)(index % width) + 1;
+		Tile& tile = game->tilemap[row][col];
+		tile.open = !tile.open;
+		flip_bit(history->open_plane, index);
+		game->changed_tiles.push_back({row, col});
+		game->refresh_view(row, col);
+	});
+
+	for_each_run_tile(delta.flag_runs, [&](uint64_t index) {
+		const int row = (int)(index / width) + 1, col = (int)(index % width) + 1;
+		Tile& tile = game->tilemap[row][col];
+		tile.flagged = !tile.flagged;
+		flip_bit(history->flag_plane, index);
+		game->changed_tiles.push_back({row, col});
+		game->refresh_view(row, col);
+	});
+
+	if(delta.dead_flipped)
+		game->dead = !game->dead;
+
+	history->dead_before = game->dead;
+}
+
+// turns the flips collected so far into an undo step
+static void end_move(undo_history* history, const Minesweeper* game)
+{
+	undo_delta delta;
+	encode_runs(&history->open_flips, &delta.open_runs);
+	encode_runs(&history->flag_flips, &delta.flag_runs);
+	delta.dead_flipped = history->dead_before != game->dead;
+	history->dead_before = game->dead;
+
+	if(delta.open_runs.empty() && delta.flag_runs.empty() && !delta.dead_flipped)
+		return;
+
+	history->memory += delta_memory(delta);
+	history->undo.push_back(std::move(delta));
+
+	// the oldest undo steps go first, then the redo steps furthest away
+	while(history->memory > history->memory_cap && !history->undo.empty()) {
+		history->memory -= delta_memory(history->undo.front());
+		history->undo.pop_front();
+	}
+
+	if(history->memory > history->memory_cap) {
+		size_t dropped = 0;
+		while(history->memory > history->memory_cap && dropped < history->redo.size())
+			history->memory -= delta_memory(history->redo[dropped++]);
+		history->redo.erase(history->redo.begin(), history->redo.begin() + dropped);
+	}
+}
+
+void undo_reset(undo_history* history, const Minesweeper* game)
+{
+	const uint64_t plane_words = ((uint64_t)game->width * game->height + 63) / 64;
+
+	history->undo.clear();
+	history->redo.clear();
+	history->memory = 0;
+	history->open_plane.assign(plane_words, 0);
+	history->flag_plane.assign(plane_words, 0);
+	history->open_flips.clear();
+	history->flag_flips.clear();
+	history->dead_before = game->dead;
+
+	// a loaded board can already have progress
+	for(int row = 1; row <= game->height; row++) {
+		for(int col = 1; col <= game->width; col++) {
+			const Tile& tile = game->tilemap[row][col];
+			const uint64_t index = (uint64_t)(row - 1) * game->width + (col - 1);
+			if(tile.open)
+				flip_bit(history->open_plane, index);
+			if(tile.flagged)
+				flip_bit(history->flag_plane, index);
+		}
+	}
+}
+
+void undo_track(undo_history* history, const Minesweeper* game)
+{
+	for(const auto& [row, col] : game->changed_tiles) {
+		const Tile& tile = game->tilemap[row][col];
+		const uint64_t index = (uint64_t)(row - 1) * game->width + (col - 1);
+
+		// tiles listed more than once, or already put back by undo_step, don't differ anymore
+		if(tile.open != (bool)((history->open_plane[index / 64] >> (index % 64)) & 1)) {
+			flip_bit(history->open_plane, index);
+			history->open_flips.push_back(index);
+		}
+
+		if(tile.flagged != (bool)((history->flag_plane[index / 64] >> (index % 64)) & 1)) {
+			flip_bit(history->flag_plane, index);
+			history->flag_flips.push_back(index);
+		}
+	}
+}
+
+void undo_begin_move(undo_history* history, const Minesweeper* game)
+{
+	undo_track(history, game);
+	end_move(history, game);
+
+	for(const undo_delta& delta : history->redo)
+		history->memory -= delta_memory(delta);
+	history->redo.clear();
+}
+
+bool undo_step(undo_history* history, Minesweeper* game)
+{
+	// the whole opening belongs to the move, a delta of half an opening would redo to a board play can't reach
+	game->finish_reveal();
+	undo_track(history, game);
+	end_move(history, game);
+
+	if(history->undo.empty())
+		return false;
+
+	undo_delta delta = std::move(history->undo.back());
+	history->undo.pop_back();
+
+	apply_delta(history, game, delta);
+	history->redo.push_back(std::move(delta));
+	return true;
+}
+
+bool redo_step(undo_history* history, Minesweeper* game)
+{
+	game->finish_reveal();
+	undo_track(history, game);
+	end_move(history, game);
+
+	if(history->redo.empty())
+		return false;
+
+	undo_delta delta = std::move(history->redo.back());
+	history->redo.pop_back();
+
+	apply_delta(history, game, delta);
+	history->undo.push_back(std::move(delta));
+	return true;
+}
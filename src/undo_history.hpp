@@ -0,0 +1,53 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "minesweeper.hpp"
+
+constexpr size_t DEFAULT_UNDO_MEMORY = 64 * 1024 * 1024;
+
+// the tiles one move changed, as runs of row-major tile indices
+// each run is a varint gap from the end of the previous run followed by a varint length
+// flood fills open whole stretches of rows, so a big opening costs a few bytes per row it touches
+struct undo_delta
+{
+	std::vector<uint8_t> open_runs;
+	std::vector<uint8_t> flag_runs;
+	bool dead_flipped = false;
+};
+
+// every delta flips bits, so undo and redo apply the same delta and cost as much as the tiles it lists
+struct undo_history
+{
+	std::deque<undo_delta> undo;
+	std::vector<undo_delta> redo;
+
+	// bytes held by both stacks, past memory_cap the oldest undo steps are dropped, then the furthest redo steps
+	size_t memory = 0;
+	size_t memory_cap = DEFAULT_UNDO_MEMORY;
+
+	// open and flag state as of the last undo_track, diffing against it tells which bit a changed tile flipped
+	std::vector<uint64_t> open_plane;
+	std::vector<uint64_t> flag_plane;
+
+	// flips of the move still being played out, a tile listed twice cancels out
+	std::vector<uint64_t> open_flips;
+	std::vector<uint64_t> flag_flips;
+	bool dead_before = false;
+};
+
+// starts an empty history for game, call again whenever the board is replaced
+void undo_reset(undo_history* history, const Minesweeper* game);
+
+// call every frame before changed_tiles is cleared, a reveal spread over frames stays part of the move that started it
+void undo_track(undo_history* history, const Minesweeper* game);
+
+// call before a move is applied, ends the previous one and drops everything that could be redone
+void undo_begin_move(undo_history* history, const Minesweeper* game);
+
+// both finish a reveal in progress first and return false if there was nothing to undo or redo
+// the tiles they touch are added to changed_tiles
+bool undo_step(undo_history* history, Minesweeper* game);
+bool redo_step(undo_history* history, Minesweeper* game);